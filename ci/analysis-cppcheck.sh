@@ -1,12 +1,13 @@
 #!/bin/bash
 set -x
 
-examples=(bootstrap tasks systemc factory)
+examples=(bootstrap tasks systemc factory multi_snr bit_packing iterative fe_capture latency custom_module fading)
 
 touch src_files.txt
 for example in ${examples[*]}; do
 	find .\/examples\/$example\/src\/ -type f -follow -print | grep "[.]h$\|[.]hpp$\|[.]hxx$\|[.]cpp$" >> src_files.txt
 done
+find .\/examples\/common\/include\/ -type f -follow -print | grep "[.]h$\|[.]hpp$\|[.]hxx$" >> src_files.txt
 
 cppcheck --version
 mkdir cppcheck
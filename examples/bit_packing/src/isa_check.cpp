@@ -0,0 +1,39 @@
+// This file is compiled for the baseline x86-64 instruction set (see 'CMakeLists.txt'), whatever the '-m' or '-march'
+// flags of the rest of the example: the check below has to run before any code compiled with these flags.
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+// instruction set required by the code compiled with the user flags, empty if there is nothing to check (defined in
+// 'main.cpp')
+extern const char required_isa[];
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__INTEL_COMPILER) && \
+    (defined(__x86_64__) || defined(__i386__))
+// stop with an explicit message instead of an illegal instruction if the CPU is too old for the compiled code, the
+// constructor runs before the static initializers of the other files (the C++ streams may not be ready yet)
+__attribute__((constructor(101)))
+static void check_required_isa()
+{
+	__builtin_cpu_init();
+
+	bool supported = true;
+// '__builtin_cpu_supports' does not know "avx512f" before GCC 5 (the AVX-512 binaries are not checked)
+#if defined(__clang__) || __GNUC__ >= 5
+	     if (!std::strcmp(required_isa, "avx512f")) supported = __builtin_cpu_supports("avx512f");
+	else
+#endif
+	     if (!std::strcmp(required_isa, "avx2"   )) supported = __builtin_cpu_supports("avx2"   );
+	else if (!std::strcmp(required_isa, "avx"    )) supported = __builtin_cpu_supports("avx"    );
+	else if (!std::strcmp(required_isa, "sse4.2" )) supported = __builtin_cpu_supports("sse4.2" );
+
+	if (!supported)
+	{
+		std::fprintf(stderr, "# (EE) This binary has been compiled for %s and the CPU does not support it, rebuild the "
+		                     "AFF3CT library and this example with a lower instruction set (e.g. -msse4.2).\n",
+		                     required_isa);
+		std::exit(1);
+	}
+}
+#endif
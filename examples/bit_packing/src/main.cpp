@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include <cstdlib>
+#include <bitset>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+// the hot kernels of this example are compiled for several instruction sets and the best version for the CPU is
+// selected when the program is loaded (GNU ifunc), the 'default' version uses the '-m' or '-march' flags: the dispatch
+// is only useful if the example is compiled with a low base instruction set (e.g. '-msse4.2', not '-march=native')
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__linux__) && !defined(__INTEL_COMPILER) && \
+    ((defined(__clang__) && __clang_major__ >= 14) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 6))
+#define KERNELS_MULTIVERSIONING
+#define KERNELS_TARGET_FLOAT  __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#define KERNELS_TARGET_POPCNT __attribute__((target_clones("popcnt", "default")))
+#else
+#define KERNELS_TARGET_FLOAT
+#define KERNELS_TARGET_POPCNT
+#endif
+
+// instruction set required by the code compiled with the user flags (the AFF3CT library is built with the same flags),
+// it is checked by 'isa_check.cpp' before any code of this file runs (the array is a constant, it needs no code)
+#if defined(__AVX512F__)
+extern const char required_isa[] = "avx512f";
+#elif defined(__AVX2__)
+extern const char required_isa[] = "avx2";
+#elif defined(__AVX__)
+extern const char required_isa[] = "avx";
+#elif defined(__SSE4_2__)
+extern const char required_isa[] = "sse4.2";
+#else
+extern const char required_isa[] = "";
+#endif
+
+// the bits are packed in 64-bit words, the bit 'i' is stored in the bit 'i % 64' of the word 'i / 64'
+using word_t = uint64_t;
+inline size_t n_words(const size_t n_bits) { return (n_bits + 63) / 64; }
+
+KERNELS_TARGET_FLOAT
+void bpsk_modulate_packed(const word_t *X_N1, float *X_N2, const int N)
+{
+	for (auto i = 0; i < N; i++)
+		X_N2[i] = 1.f - 2.f * (float)((X_N1[i / 64] >> (i % 64)) & 1);
+}
+
+KERNELS_TARGET_FLOAT
+void repetition_decode_packed(const float *Y_N, word_t *V_K, const int K, const int N)
+{
+	const auto n_words_K = (int)n_words(K);
+	for (auto w = 0; w < n_words_K; w++)
+	{
+		const auto k_start = w * 64;
+		const auto k_stop  = std::min(k_start + 64, K);
+
+		word_t word = 0;
+		for (auto k = k_start; k < k_stop; k++)
+		{
+			auto sum = 0.f;
+			for (auto off = 0; off < N; off += K)
+				sum += Y_N[off + k];
+			word |= (word_t)(sum < 0.f) << (k - k_start);
+		}
+		V_K[w] = word;
+	}
+}
+
+KERNELS_TARGET_POPCNT
+int popcount_xor(const word_t *U, const word_t *V, const size_t n_words)
+{
+	auto n = 0;
+	for (size_t w = 0; w < n_words; w++)
+		n += (int)std::bitset<64>(U[w] ^ V[w]).count();
+	return n;
+}
+
+// name of the instruction set selected for the hot kernels
+std::string get_kernels_isa()
+{
+#ifdef KERNELS_MULTIVERSIONING
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) return "AVX-512F";
+	if (__builtin_cpu_supports("avx2"   )) return "AVX2";
+	if (__builtin_cpu_supports("sse4.2" )) return "SSE4.2";
+	return "x86-64";
+#else
+	return "compile-time";
+#endif
+}
+
+// generate random bits directly in the packed representation (one PRNG draw gives 64 bits)
+class Source_random_packed
+{
+protected:
+	const int       K;
+	std::mt19937_64 rd_engine;
+
+public:
+	Source_random_packed(const int K, const int seed = 0) : K(K), rd_engine(seed) {}
+
+	void generate(std::vector<word_t> &U_K)
+	{
+		for (auto &w : U_K)
+			w = this->rd_engine();
+
+		// the padding bits of the last word are always zero
+		if (this->K % 64)
+			U_K.back() &= ((word_t)1 << (this->K % 64)) - 1;
+	}
+};
+
+// systematic repetition encoder (buffered): the K information bits are copied N/K times in the codeword
+class Encoder_repetition_sys_packed
+{
+protected:
+	const int K;
+	const int N;
+
+public:
+	Encoder_repetition_sys_packed(const int K, const int N) : K(K), N(N) {}
+
+	void encode(const std::vector<word_t> &U_K, std::vector<word_t> &X_N)
+	{
+		std::fill(X_N.begin(), X_N.end(), (word_t)0);
+
+		const auto n_words_K = n_words(this->K);
+		for (auto off = 0; off < this->N; off += this->K)
+		{
+			// copy U_K at the bit position 'off' of X_N
+			const auto shift = off % 64;
+			const auto first = (size_t)off / 64;
+			for (size_t i = 0; i < n_words_K; i++)
+			{
+				X_N[first + i] |= U_K[i] << shift;
+				if (shift && first + i + 1 < X_N.size())
+					X_N[first + i + 1] |= U_K[i] >> (64 - shift);
+			}
+		}
+	}
+};
+
+// BPSK modulation from the packed bits (0 -> +1, 1 -> -1), the same mapping as 'module::Modem_BPSK'
+class Modem_BPSK_packed
+{
+protected:
+	const int N;
+
+public:
+	explicit Modem_BPSK_packed(const int N) : N(N) {}
+
+	void modulate(const std::vector<word_t> &X_N1, std::vector<float> &X_N2)
+	{
+		bpsk_modulate_packed(X_N1.data(), X_N2.data(), this->N);
+	}
+};
+
+// repetition decoder (buffered): accumulate the LLRs of the repetitions and pack the hard decisions
+class Decoder_repetition_std_packed
+{
+protected:
+	const int K;
+	const int N;
+
+public:
+	Decoder_repetition_std_packed(const int K, const int N) : K(K), N(N) {}
+
+	void decode_siho(const std::vector<float> &Y_N, std::vector<word_t> &V_K)
+	{
+		repetition_decode_packed(Y_N.data(), V_K.data(), this->K, this->N);
+	}
+};
+
+// count the bit and frame errors with a population count over the XOR of the packed words
+class Monitor_BFER_packed
+{
+protected:
+	const int                             K;
+	const unsigned                        max_fe;
+	unsigned long long                    n_be;
+	unsigned                              n_fe;
+	unsigned long long                    n_fra;
+	std::chrono::steady_clock::time_point t_start;
+
+public:
+	Monitor_BFER_packed(const int K, const unsigned max_fe) : K(K), max_fe(max_fe) { this->reset(); }
+
+	int check_errors(const std::vector<word_t> &U, const std::vector<word_t> &V)
+	{
+		const auto n_errors = popcount_xor(U.data(), V.data(), U.size());
+
+		this->n_be  += n_errors;
+		this->n_fe  += n_errors ? 1 : 0;
+		this->n_fra++;
+
+		return n_errors;
+	}
+
+	bool fe_limit_achieved() const { return this->n_fe >= this->max_fe; }
+
+	int                                   get_K             () const { return this->K;       }
+	unsigned long long                    get_n_be          () const { return this->n_be;    }
+	unsigned                              get_n_fe          () const { return this->n_fe;    }
+	unsigned long long                    get_n_analyzed_fra() const { return this->n_fra;   }
+	std::chrono::steady_clock::time_point get_t_start       () const { return this->t_start; }
+
+	void reset()
+	{
+		this->n_be    = 0;
+		this->n_fe    = 0;
+		this->n_fra   = 0;
+		this->t_start = std::chrono::steady_clock::now();
+	}
+};
+
+// report the bit/frame error rates and the simulation throughput of a 'Monitor_BFER_packed'
+class Reporter_BFER_packed : public tools::Reporter
+{
+protected:
+	const Monitor_BFER_packed &monitor;
+
+public:
+	explicit Reporter_BFER_packed(const Monitor_BFER_packed &monitor)
+	: Reporter(), monitor(monitor)
+	{
+		title_t bfer_title = {"Bit Error Rate (BER) and Frame Error Rate (FER)", ""};
+		std::vector<title_t> bfer_cols = { {"FRA", ""}, {"BE", ""}, {"FE", ""}, {"BER", ""}, {"FER", ""} };
+		this->cols_groups.push_back(group_t(bfer_title, bfer_cols));
+
+		title_t thr_title = {"Global throughput", "and elapsed time"};
+		std::vector<title_t> thr_cols = { {"SIM_THR", "(Mb/s)"}, {"ET", "(sec)"} };
+		this->cols_groups.push_back(group_t(thr_title, thr_cols));
+	}
+
+	virtual ~Reporter_BFER_packed() = default;
+
+	report_t report(bool final = false)
+	{
+		const auto n_fra = this->monitor.get_n_analyzed_fra();
+		const auto n_be  = this->monitor.get_n_be();
+		const auto n_fe  = this->monitor.get_n_fe();
+		const auto ber   = n_fra ? (double)n_be / ((double)n_fra * (double)this->monitor.get_K()) : 0.;
+		const auto fer   = n_fra ? (double)n_fe / (double)n_fra : 0.;
+
+		const auto et  = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->monitor.get_t_start());
+		const auto thr = et.count() > 0. ? ((double)n_fra * (double)this->monitor.get_K()) / (et.count() * 1e6) : 0.;
+
+		report_t report(this->cols_groups.size());
+
+		std::stringstream ss_ber, ss_fer, ss_thr, ss_et;
+		ss_ber << std::setprecision(2) << std::scientific << ber;
+		ss_fer << std::setprecision(2) << std::scientific << fer;
+		ss_thr << std::setprecision(3) << std::fixed      << thr;
+		ss_et  << std::setprecision(2) << std::fixed      << et.count();
+
+		report[0] = { std::to_string(n_fra), std::to_string(n_be), std::to_string(n_fe), ss_ber.str(), ss_fer.str() };
+		report[1] = { ss_thr.str(), ss_et.str() };
+
+		return report;
+	}
+};
+
+struct params
+{
+	int   K         =  32;     // number of information bits
+	int   N         = 128;     // codeword size (has to be a multiple of K)
+	int   fe        = 100;     // number of frame errors
+	int   seed      =   0;     // PRNG seed for the source and the AWGN channel
+	float ebn0_min  =   0.00f; // minimum SNR value
+	float ebn0_max  =  10.01f; // maximum SNR value
+	float ebn0_step =   1.00f; // SNR step
+	float R;                   // code rate (R=K/N)
+};
+void init_params(params &p);
+
+struct modules
+{
+	std::unique_ptr<Source_random_packed>          source;
+	std::unique_ptr<Encoder_repetition_sys_packed> encoder;
+	std::unique_ptr<Modem_BPSK_packed>             modulator;
+	std::unique_ptr<module::Modem_BPSK<>>          modem;     // demodulation only
+	std::unique_ptr<module::Channel_AWGN_LLR<>>    channel;
+	std::unique_ptr<Decoder_repetition_std_packed> decoder;
+	std::unique_ptr<Monitor_BFER_packed>           monitor;
+};
+void init_modules(const params &p, modules &m);
+
+struct buffers
+{
+	std::vector<word_t> ref_bits; // packed information bits
+	std::vector<word_t> enc_bits; // packed codeword bits
+	std::vector<float > symbols;
+	std::vector<float > noisy_symbols;
+	std::vector<float > LLRs;
+	std::vector<word_t> dec_bits; // packed decoded bits
+};
+void init_buffers(const params &p, buffers &b);
+
+struct utils
+{
+	std::unique_ptr<tools::Sigma<>>               noise;     // a sigma noise type
+	std::vector<std::unique_ptr<tools::Reporter>> reporters; // list of reporters dispayed in the terminal
+	std::unique_ptr<tools::Terminal_std>          terminal;  // manage the output text in the terminal
+};
+void init_utils(const modules &m, utils &u);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# SIMD: compiled for " << mipp::InstructionFullType << " (compile time)"
+	          << ", packed kernels dispatched to " << get_kernels_isa() << " (run time)" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params p;  init_params (p   ); // create and initialize the parameters defined by the user
+	modules m; init_modules(p, m); // create and initialize the modules
+	buffers b; init_buffers(p, b); // create and initialize the buffers required by the modules
+	utils u;   init_utils  (m, u); // create and initialize the utils
+
+	// display the legend in the terminal
+	u.terminal->legend();
+
+	// loop over the various SNRs
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+	{
+		// compute the current sigma for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
+		const auto sigma = tools::esn0_to_sigma(esn0     );
+
+		u.noise->set_noise(sigma, ebn0, esn0);
+
+		// update the sigma of the modem and the channel
+		m.modem  ->set_noise(*u.noise);
+		m.channel->set_noise(*u.noise);
+
+		// display the performance (BER and FER) in real time (in a separate thread)
+		u.terminal->start_temp_report();
+
+		// run the simulation chain
+		while (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+		{
+			m.source   ->generate    (                 b.ref_bits     );
+			m.encoder  ->encode      (b.ref_bits,      b.enc_bits     );
+			m.modulator->modulate    (b.enc_bits,      b.symbols      );
+			m.channel  ->add_noise   (b.symbols,       b.noisy_symbols);
+			m.modem    ->demodulate  (b.noisy_symbols, b.LLRs         );
+			m.decoder  ->decode_siho (b.LLRs,          b.dec_bits     );
+			m.monitor  ->check_errors(b.dec_bits,      b.ref_bits     );
+		}
+
+		// display the performance (BER and FER) in the terminal
+		u.terminal->final_report();
+
+		// reset the monitor for the next SNR
+		m.monitor->reset();
+		u.terminal->reset();
+
+		// if user pressed Ctrl+c twice, exit the SNRs loop
+		if (u.terminal->is_over()) break;
+	}
+
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+void init_params(params &p)
+{
+	p.R = (float)p.K / (float)p.N;
+	std::cout << "# * Simulation parameters: "              << std::endl;
+	std::cout << "#    ** Frame errors   = " << p.fe        << std::endl;
+	std::cout << "#    ** Noise seed     = " << p.seed      << std::endl;
+	std::cout << "#    ** Info. bits (K) = " << p.K         << std::endl;
+	std::cout << "#    ** Frame size (N) = " << p.N         << std::endl;
+	std::cout << "#    ** Code rate  (R) = " << p.R         << std::endl;
+	std::cout << "#    ** SNR min   (dB) = " << p.ebn0_min  << std::endl;
+	std::cout << "#    ** SNR max   (dB) = " << p.ebn0_max  << std::endl;
+	std::cout << "#    ** SNR step  (dB) = " << p.ebn0_step << std::endl;
+	std::cout << "#"                                        << std::endl;
+}
+
+void init_modules(const params &p, modules &m)
+{
+	m.source    = std::unique_ptr<Source_random_packed         >(new Source_random_packed         (p.K, p.seed ));
+	m.encoder   = std::unique_ptr<Encoder_repetition_sys_packed>(new Encoder_repetition_sys_packed(p.K, p.N    ));
+	m.modulator = std::unique_ptr<Modem_BPSK_packed            >(new Modem_BPSK_packed            (p.N         ));
+	m.modem     = std::unique_ptr<module::Modem_BPSK<>         >(new module::Modem_BPSK<>         (p.N         ));
+	m.channel   = std::unique_ptr<module::Channel_AWGN_LLR<>   >(new module::Channel_AWGN_LLR<>   (p.N, p.seed ));
+	m.decoder   = std::unique_ptr<Decoder_repetition_std_packed>(new Decoder_repetition_std_packed(p.K, p.N    ));
+	m.monitor   = std::unique_ptr<Monitor_BFER_packed          >(new Monitor_BFER_packed          (p.K, p.fe   ));
+};
+
+void init_buffers(const params &p, buffers &b)
+{
+	b.ref_bits      = std::vector<word_t>(n_words(p.K));
+	b.enc_bits      = std::vector<word_t>(n_words(p.N));
+	b.symbols       = std::vector<float >(p.N);
+	b.noisy_symbols = std::vector<float >(p.N);
+	b.LLRs          = std::vector<float >(p.N);
+	b.dec_bits      = std::vector<word_t>(n_words(p.K));
+}
+
+void init_utils(const modules &m, utils &u)
+{
+	// create a sigma noise type
+	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	// report the noise values (Es/N0 and Eb/N0)
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
+	// report the bit/frame error rates and the simulation throughput
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new Reporter_BFER_packed(*m.monitor)));
+	// create a terminal that will display the collected data from the reporters
+	u.terminal = std::unique_ptr<tools::Terminal_std>(new tools::Terminal_std(u.reporters));
+}
@@ -0,0 +1,80 @@
+#ifndef INTERLEAVER_CACHE_HPP
+#define INTERLEAVER_CACHE_HPP
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <aff3ct.hpp>
+
+// generate the interleaver LUT once and store it in a cache file, then switch the interleaver parameters to the "USER"
+// type: the codecs built afterward (in this run, in the other threads and in the next runs) load the LUT from the file
+// instead of generating it, if the file can't be written the parameters are left unchanged
+inline void init_interleaver_cache(aff3ct::factory::Interleaver_core::parameters &core, const std::string &prefix)
+{
+	using namespace aff3ct;
+
+	// nothing to cache if the interleaver LUT changes for each frame
+	if (prefix.empty() || core.uniform || core.type == "USER")
+		return;
+
+	// the LUT only depends on these parameters, they are used as the key of the cache
+	std::stringstream key;
+	key << core.type << "_" << core.read_order << "_" << core.n_cols << "_" << core.size << "_" << core.seed;
+	const auto path = prefix + key.str() + ".lut";
+
+	const bool hit = std::ifstream(path).good();
+	if (!hit)
+	{
+		std::unique_ptr<tools::Interleaver_core<>> itl(factory::Interleaver_core::build<>(core));
+		itl->init();
+
+		// write the LUT in the "USER" interleaver format (number of LUTs, LUT size, LUT values) in a file specific to
+		// this process, then rename it to never expose a partially written LUT to the concurrent runs
+		std::stringstream tmp;
+#ifdef _WIN32
+		tmp << path << "." << _getpid() << ".tmp";
+#else
+		tmp << path << "." <<  getpid() << ".tmp";
+#endif
+		const auto tmp_path = tmp.str();
+		std::ofstream file(tmp_path);
+		file << 1 << std::endl << itl->get_size() << std::endl;
+		for (auto v : itl->get_lut())
+			file << v << " ";
+		file << std::endl;
+		file.close();
+
+		// POSIX 'rename' atomically replaces the LUT written by a concurrent run (the LUTs are identical), on Windows
+		// it fails when the file already exists and the LUT of the other run is used
+		if (file.fail() || std::rename(tmp_path.c_str(), path.c_str()))
+		{
+			std::remove(tmp_path.c_str());
+			if (!std::ifstream(path).good())
+			{
+				std::cerr << "# Warning: the interleaver LUT cache can't be written (" << path << "), the LUT is "
+				          << "generated by the codecs." << std::endl;
+				std::cerr << "#" << std::endl;
+				return;
+			}
+		}
+	}
+
+	// the codecs will now load the LUT from the cache file instead of generating it
+	core.type = "USER";
+	core.path = path;
+
+	std::cout << "# Interleaver LUT cache " << (hit ? "hit" : "miss") << " (" << path << ")" << std::endl;
+	std::cout << "#" << std::endl;
+}
+
+#endif /* INTERLEAVER_CACHE_HPP */
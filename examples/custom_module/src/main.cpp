@@ -0,0 +1,372 @@
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+struct params
+{
+	int   K         =  32;     // number of information bits
+	int   N         = 128;     // codeword size
+	int   fe        = 100;     // number of frame errors
+	int   seed      =   0;     // PRNG seed for the AWGN channel
+	float ebn0_min  =   0.00f; // minimum SNR value
+	float ebn0_max  =  10.01f; // maximum SNR value
+	float ebn0_step =   1.00f; // SNR step
+	float R;                   // code rate (R=K/N)
+	bool  fused     = true;    // fuse the demodulator and the decoder in a single task
+};
+void init_params(params &p);
+
+namespace stg
+{
+	enum class tsk : size_t { process, SIZE };
+
+	namespace sck
+	{
+		enum class process : size_t { in, out, SIZE };
+	}
+}
+
+// base of the custom modules: a stage has a 'process' task with an 'in' and an 'out' socket, the task calls the
+// '_process' method of the derived class 'D' without virtual dispatch (CRTP), so it can be inlined
+template <class D, typename TI, typename TO>
+class Stage : public module::Module
+{
+public:
+	using in_t  = TI;
+	using out_t = TO;
+
+	inline module::Task&   operator[](const stg::tsk          t) { return Module::operator[]((size_t)t);         }
+	inline module::Socket& operator[](const stg::sck::process s) { return (*this)[stg::tsk::process][(size_t)s]; }
+
+protected:
+	const int N_in;  // number of input  elements per frame
+	const int N_out; // number of output elements per frame
+
+public:
+	Stage(const std::string &name, const int N_in, const int N_out, const int n_frames = 1)
+	: Module(n_frames), N_in(N_in), N_out(N_out)
+	{
+		this->set_name(name);
+		this->set_short_name(name);
+
+		auto &p = this->create_task("process");
+		auto ps_in  = this->template create_socket_in <TI>(p, "in",  this->N_in  * this->get_n_frames());
+		auto ps_out = this->template create_socket_out<TO>(p, "out", this->N_out * this->get_n_frames());
+		this->create_codelet(p, [ps_in, ps_out](module::Module &m, module::Task &t) -> int
+		{
+			static_cast<Stage<D,TI,TO>&>(m).process(static_cast<const TI*>(t[ps_in ].get_dataptr()),
+			                                        static_cast<      TO*>(t[ps_out].get_dataptr()));
+			return 0;
+		});
+	}
+
+	virtual ~Stage() = default;
+
+	int get_N_in () const { return this->N_in;  }
+	int get_N_out() const { return this->N_out; }
+
+	template <class AI = std::allocator<TI>, class AO = std::allocator<TO>>
+	void process(const std::vector<TI,AI> &in, std::vector<TO,AO> &out)
+	{
+		if (in.size() != (size_t)(this->N_in * this->get_n_frames()) ||
+		    out.size() != (size_t)(this->N_out * this->get_n_frames()))
+		{
+			std::stringstream message;
+			message << "'in.size()' has to be equal to 'N_in' * 'n_frames' and 'out.size()' has to be equal to "
+			        << "'N_out' * 'n_frames' ('in.size()' = " << in.size() << ", 'out.size()' = " << out.size()
+			        << ", 'N_in' = " << this->N_in << ", 'N_out' = " << this->N_out
+			        << ", 'n_frames' = " << this->get_n_frames() << ").";
+			throw tools::length_error(__FILE__, __LINE__, __func__, message.str());
+		}
+
+		this->process(in.data(), out.data());
+	}
+
+	inline void process(const TI *in, TO *out)
+	{
+		for (auto f = 0; f < this->get_n_frames(); f++)
+			static_cast<D*>(this)->_process(in + f * this->N_in, out + f * this->N_out, f);
+	}
+};
+
+// fuse two stages in a single task: the intermediate frame stays in the cache and the '_process' methods of the two
+// stages are inlined in the same function
+template <class S1, class S2>
+class Stage_fused : public Stage<Stage_fused<S1,S2>, typename S1::in_t, typename S2::out_t>
+{
+protected:
+	S1 &s1;
+	S2 &s2;
+	std::vector<typename S1::out_t> tmp; // output of 's1' for one frame
+
+public:
+	Stage_fused(S1 &s1, S2 &s2)
+	: Stage<Stage_fused<S1,S2>, typename S1::in_t, typename S2::out_t>(s1.get_name() + "+" + s2.get_name(),
+	                                                                  s1.get_N_in(), s2.get_N_out(),
+	                                                                  s1.get_n_frames()),
+	  s1(s1), s2(s2), tmp(s1.get_N_out())
+	{
+	}
+
+	virtual ~Stage_fused() = default;
+
+	inline void _process(const typename S1::in_t *in, typename S2::out_t *out, const int frame_id)
+	{
+		this->s1._process(in,               this->tmp.data(), frame_id);
+		this->s2._process(this->tmp.data(), out,              frame_id);
+	}
+};
+
+// BPSK modulation: 0 -> +1, 1 -> -1
+class Modulator_BPSK : public Stage<Modulator_BPSK, int, float>
+{
+public:
+	explicit Modulator_BPSK(const int N, const int n_frames = 1)
+	: Stage<Modulator_BPSK, int, float>("Modulator_BPSK", N, N, n_frames)
+	{
+	}
+
+	inline void _process(const int *X_N, float *Y_N, const int frame_id)
+	{
+		for (auto i = 0; i < this->N_out; i++)
+			Y_N[i] = X_N[i] ? -1.f : 1.f;
+	}
+};
+
+// BPSK demodulation: LLR = 2 * y / sigma^2
+class Demodulator_BPSK : public Stage<Demodulator_BPSK, float, float>
+{
+protected:
+	float factor = 1.f;
+
+public:
+	explicit Demodulator_BPSK(const int N, const int n_frames = 1)
+	: Stage<Demodulator_BPSK, float, float>("Demodulator_BPSK", N, N, n_frames)
+	{
+	}
+
+	void set_noise(const tools::Sigma<> &noise)
+	{
+		this->factor = 2.f / (noise.get_value() * noise.get_value());
+	}
+
+	inline void _process(const float *Y_N, float *L_N, const int frame_id)
+	{
+		for (auto i = 0; i < this->N_out; i++)
+			L_N[i] = Y_N[i] * this->factor;
+	}
+};
+
+// hard decision on the sum of the LLRs of the repetitions (systematic repetition code with the buffered layout)
+class Decoder_repetition : public Stage<Decoder_repetition, float, int>
+{
+protected:
+	const int rep_count;
+
+public:
+	Decoder_repetition(const int K, const int N, const int n_frames = 1)
+	: Stage<Decoder_repetition, float, int>("Decoder_repetition", N, K, n_frames), rep_count(N / K)
+	{
+	}
+
+	inline void _process(const float *Y_N, int *V_K, const int frame_id)
+	{
+		const auto K = this->N_out;
+		for (auto i = 0; i < K; i++)
+		{
+			auto l = Y_N[i];
+			for (auto r = 1; r < this->rep_count; r++)
+				l += Y_N[r * K + i];
+			V_K[i] = l < 0.f ? 1 : 0;
+		}
+	}
+};
+
+using Receiver = Stage_fused<Demodulator_BPSK, Decoder_repetition>;
+
+struct modules
+{
+	std::unique_ptr<module::Source_random<>>          source;
+	std::unique_ptr<module::Encoder_repetition_sys<>> encoder;
+	std::unique_ptr<Modulator_BPSK>                   modulator;   // custom stage
+	std::unique_ptr<module::Channel_AWGN_LLR<>>       channel;
+	std::unique_ptr<Demodulator_BPSK>                 demodulator; // custom stage
+	std::unique_ptr<Decoder_repetition>               decoder;     // custom stage
+	std::unique_ptr<Receiver>                         receiver;    // fusion of the demodulator and the decoder
+	std::unique_ptr<module::Monitor_BFER<>>           monitor;
+	std::vector<const module::Module*>                list; // list of the module pointers executed in the chain
+};
+void init_modules(const params &p, modules &m);
+
+struct utils
+{
+	std::unique_ptr<tools::Sigma<>>               noise;     // a sigma noise type
+	std::vector<std::unique_ptr<tools::Reporter>> reporters; // list of reporters dispayed in the terminal
+	std::unique_ptr<tools::Terminal_std>          terminal;  // manage the output text in the terminal
+};
+void init_utils(const modules &m, utils &u);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params  p; init_params (p   ); // create and initialize the parameters defined by the user
+	modules m; init_modules(p, m); // create and initialize the modules
+	utils   u; init_utils  (m, u); // create and initialize the utils
+
+	// display the legend in the terminal
+	u.terminal->legend();
+
+	// sockets binding (connect the sockets of the tasks = fill the input sockets with the output sockets)
+	using namespace module;
+	(*m.encoder  )[enc::sck::encode      ::U_K].bind((*m.source   )[src::sck::generate ::U_K ]);
+	(*m.modulator)[stg::sck::process     ::in ].bind((*m.encoder  )[enc::sck::encode   ::X_N ]);
+	(*m.channel  )[chn::sck::add_noise   ::X_N].bind((*m.modulator)[stg::sck::process  ::out ]);
+	(*m.monitor  )[mnt::sck::check_errors::U  ].bind((*m.encoder  )[enc::sck::encode   ::U_K ]);
+	if (p.fused)
+	{
+		(*m.receiver   )[stg::sck::process     ::in].bind((*m.channel    )[chn::sck::add_noise::Y_N]);
+		(*m.monitor    )[mnt::sck::check_errors::V ].bind((*m.receiver   )[stg::sck::process  ::out]);
+	}
+	else
+	{
+		(*m.demodulator)[stg::sck::process     ::in].bind((*m.channel    )[chn::sck::add_noise::Y_N]);
+		(*m.decoder    )[stg::sck::process     ::in].bind((*m.demodulator)[stg::sck::process  ::out]);
+		(*m.monitor    )[mnt::sck::check_errors::V ].bind((*m.decoder    )[stg::sck::process  ::out]);
+	}
+
+	// the chain of tasks executed for each frame
+	std::vector<module::Task*> chain = { &(*m.source   )[src::tsk::generate ],
+	                                     &(*m.encoder  )[enc::tsk::encode   ],
+	                                     &(*m.modulator)[stg::tsk::process  ],
+	                                     &(*m.channel  )[chn::tsk::add_noise] };
+	if (p.fused)
+		chain.push_back(&(*m.receiver)[stg::tsk::process]);
+	else
+	{
+		chain.push_back(&(*m.demodulator)[stg::tsk::process]);
+		chain.push_back(&(*m.decoder    )[stg::tsk::process]);
+	}
+	chain.push_back(&(*m.monitor)[mnt::tsk::check_errors]);
+
+	// loop over the various SNRs
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+	{
+		// compute the current sigma for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
+		const auto sigma = tools::esn0_to_sigma(esn0     );
+
+		u.noise->set_noise(sigma, ebn0, esn0);
+
+		// update the sigma of the demodulator (also used by the fused receiver) and the channel
+		m.demodulator->set_noise(*u.noise);
+		m.channel    ->set_noise(*u.noise);
+
+		// display the performance (BER and FER) in real time (in a separate thread)
+		u.terminal->start_temp_report();
+
+		// run the simulation chain
+		while (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+			for (auto t : chain)
+				t->exec();
+
+		// display the performance (BER and FER) in the terminal
+		u.terminal->final_report();
+
+		// reset the monitor and the terminal for the next SNR
+		m.monitor->reset();
+		u.terminal->reset();
+
+		// if user pressed Ctrl+c twice, exit the SNRs loop
+		if (u.terminal->is_over()) break;
+	}
+
+	// display the statistics of the tasks (if enabled)
+	std::cout << "#" << std::endl;
+	tools::Stats::show(m.list, true);
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+void init_params(params &p)
+{
+	p.R = (float)p.K / (float)p.N;
+	std::cout << "# * Simulation parameters: "                              << std::endl;
+	std::cout << "#    ** Frame errors   = " << p.fe                        << std::endl;
+	std::cout << "#    ** Noise seed     = " << p.seed                      << std::endl;
+	std::cout << "#    ** Info. bits (K) = " << p.K                         << std::endl;
+	std::cout << "#    ** Frame size (N) = " << p.N                         << std::endl;
+	std::cout << "#    ** Code rate  (R) = " << p.R                         << std::endl;
+	std::cout << "#    ** SNR min   (dB) = " << p.ebn0_min                  << std::endl;
+	std::cout << "#    ** SNR max   (dB) = " << p.ebn0_max                  << std::endl;
+	std::cout << "#    ** SNR step  (dB) = " << p.ebn0_step                 << std::endl;
+	std::cout << "#    ** Fused stages   = " << (p.fused ? "yes" : "no")    << std::endl;
+	std::cout << "#"                                                        << std::endl;
+}
+
+void init_modules(const params &p, modules &m)
+{
+	m.source      = std::unique_ptr<module::Source_random         <>>(new module::Source_random         <>(p.K        ));
+	m.encoder     = std::unique_ptr<module::Encoder_repetition_sys<>>(new module::Encoder_repetition_sys<>(p.K, p.N   ));
+	m.modulator   = std::unique_ptr<Modulator_BPSK                  >(new Modulator_BPSK                  (p.N        ));
+	m.channel     = std::unique_ptr<module::Channel_AWGN_LLR      <>>(new module::Channel_AWGN_LLR      <>(p.N, p.seed));
+	m.demodulator = std::unique_ptr<Demodulator_BPSK                >(new Demodulator_BPSK                (p.N        ));
+	m.decoder     = std::unique_ptr<Decoder_repetition              >(new Decoder_repetition              (p.K, p.N   ));
+	m.monitor     = std::unique_ptr<module::Monitor_BFER          <>>(new module::Monitor_BFER          <>(p.K, p.fe  ));
+	if (p.fused)
+		m.receiver = std::unique_ptr<Receiver>(new Receiver(*m.demodulator, *m.decoder));
+
+	m.list = { m.source.get(), m.encoder.get(), m.modulator.get(), m.channel.get() };
+	if (p.fused)
+		m.list.push_back(m.receiver.get());
+	else
+	{
+		m.list.push_back(m.demodulator.get());
+		m.list.push_back(m.decoder.get());
+	}
+	m.list.push_back(m.monitor.get());
+
+	// configuration of the module tasks
+	for (auto& mod : m.list)
+		for (auto& tsk : mod->tasks)
+		{
+			tsk->set_autoalloc  (true ); // enable the automatic allocation of the data in the tasks
+			tsk->set_autoexec   (false); // disable the auto execution mode of the tasks
+			tsk->set_debug      (false); // disable the debug mode
+			tsk->set_debug_limit(16   ); // display only the 16 first bits if the debug mode is enabled
+			tsk->set_stats      (true ); // enable the statistics
+
+			// enable the fast mode (= disable the useless verifs in the tasks) if there is no debug and stats modes
+			if (!tsk->is_debug() && !tsk->is_stats())
+				tsk->set_fast(true);
+		}
+}
+
+void init_utils(const modules &m, utils &u)
+{
+	// create a sigma noise type
+	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	// report the noise values (Es/N0 and Eb/N0)
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
+	// report the bit/frame error rates
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*m.monitor)));
+	// report the simulation throughputs
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*m.monitor)));
+	// create a terminal that will display the collected data from the reporters
+	u.terminal = std::unique_ptr<tools::Terminal_std>(new tools::Terminal_std(u.reporters));
+}
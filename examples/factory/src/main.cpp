@@ -1,14 +1,32 @@
 #include <functional>
 #include <exception>
+#include <algorithm>
 #include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
 #include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
 #include <memory>
 #include <vector>
+#include <map>
 #include <string>
 
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+#include <fcntl.h>
+
 #include <aff3ct.hpp>
 using namespace aff3ct;
 
+#include <interleaver_cache.hpp>
+
 struct params
 {
 	float ebn0_min  =  0.00f; // minimum SNR value
@@ -16,6 +34,11 @@ struct params
 	float ebn0_step =  1.00f; // SNR step
 	float R;                  // code rate (R=K/N)
 
+	std::string itl_cache  = "";            // prefix of the interleaver LUT cache files (empty = disable the cache), the
+	                                        // repetition codec has no interleaver: only useful with another codec
+	std::string results_db = "";            // file of the results accumulated over the runs (empty = disable it, e.g.
+	                                        // ".results.db" to enable it)
+
 	std::unique_ptr<factory::Source          ::parameters> source;
 	std::unique_ptr<factory::Codec_repetition::parameters> codec;
 	std::unique_ptr<factory::Modem           ::parameters> modem;
@@ -25,6 +48,79 @@ struct params
 };
 void init_params(int argc, char** argv, params &p);
 
+// results of an SNR point accumulated over the previous runs
+struct db_entry
+{
+	uint32_t n_runs   = 0;
+	uint64_t n_frames = 0;
+	uint64_t n_be     = 0;
+	uint64_t n_fe     = 0;
+};
+
+// record appended to the results database at the end of each SNR point of a run
+struct db_record
+{
+	uint64_t hash;     // hash of the simulation parameters
+	float    ebn0;
+	uint32_t reserved;
+	uint64_t n_frames;
+	uint64_t n_be;
+	uint64_t n_fe;
+};
+
+struct results
+{
+	uint64_t                hash;    // hash of the simulation parameters (the stop criteria are excluded)
+	uint32_t                n_runs;  // number of previous runs with the same parameters
+	std::map<int, db_entry> entries; // results of the previous runs, the key is the Eb/N0 in milli-dB
+	db_entry                current; // results of the previous runs for the current SNR point
+};
+void init_results(params &p, results &r);
+void append_result(const params &p, const results &r, const float ebn0, const module::Monitor_BFER<> &monitor);
+
+class Reporter_db : public tools::Reporter
+{
+protected:
+	const db_entry                &previous;
+	const module::Monitor_BFER<>  &monitor;
+
+public:
+	Reporter_db(const db_entry &previous, const module::Monitor_BFER<> &monitor)
+	: Reporter(), previous(previous), monitor(monitor)
+	{
+		title_t db_title = {"Results database", "(all the runs)"};
+		std::vector<title_t> db_cols = { {"RUNS", ""},
+		                                 {"FRA",  ""},
+		                                 {"FE",   ""},
+		                                 {"BER",  ""},
+		                                 {"FER",  ""} };
+		this->cols_groups.push_back(group_t(db_title, db_cols));
+	}
+
+	virtual ~Reporter_db() = default;
+
+	report_t report(bool final = false)
+	{
+		const auto n_frames = this->previous.n_frames + this->monitor.get_n_analyzed_fra();
+		const auto n_be     = this->previous.n_be     + this->monitor.get_n_be();
+		const auto n_fe     = this->previous.n_fe     + this->monitor.get_n_fe();
+		const auto ber      = n_frames ? (double)n_be / ((double)n_frames * this->monitor.get_K()) : 0.;
+		const auto fer      = n_frames ? (double)n_fe /  (double)n_frames                          : 0.;
+
+		std::stringstream ss_ber, ss_fer;
+		ss_ber << std::setprecision(2) << std::scientific << ber;
+		ss_fer << std::setprecision(2) << std::scientific << fer;
+
+		// the current run is only added to the database if it has simulated frames
+		const auto n_runs = this->previous.n_runs + (this->monitor.get_n_analyzed_fra() ? 1 : 0);
+
+		report_t report(this->cols_groups.size());
+		report[0] = { std::to_string(n_runs), std::to_string(n_frames), std::to_string(n_fe), ss_ber.str(),
+		              ss_fer.str() };
+		return report;
+	}
+};
+
 struct modules
 {
 	std::unique_ptr<module::Source<>>       source;
@@ -44,7 +140,7 @@ struct utils
 	std::vector<std::unique_ptr<tools::Reporter>> reporters; // list of reporters dispayed in the terminal
 	std::unique_ptr<tools::Terminal>              terminal;  // manage the output text in the terminal
 };
-void init_utils(const params &p, const modules &m, utils &u);
+void init_utils(const params &p, const modules &m, const results &r, utils &u);
 
 int main(int argc, char** argv)
 {
@@ -60,8 +156,11 @@ int main(int argc, char** argv)
 	std::cout << "#"                                                                << std::endl;
 
 	params  p; init_params (argc, argv, p); // create and initialize the parameters from the command line with factories
+	results r; init_results(p, r         ); // load the results of the previous runs with the same parameters
+	if (p.codec->itl)                       // generate the interleaver LUT once and reuse it from the disk afterward
+		init_interleaver_cache(*p.codec->itl->core, p.itl_cache);
 	modules m; init_modules(p, m         ); // create and initialize the modules
-	utils   u; init_utils  (p, m, u      ); // create and initialize the utils
+	utils   u; init_utils  (p, m, r, u   ); // create and initialize the utils
 
 	// display the legend in the terminal
 	u.terminal->legend();
@@ -90,11 +189,17 @@ int main(int argc, char** argv)
 		m.modem  ->set_noise(*u.noise);
 		m.channel->set_noise(*u.noise);
 
+		// only simulate the frame errors missing to the previous runs to reach the frame errors limit
+		const auto it = r.entries.find((int)std::round(ebn0 * 1000.f));
+		r.current = it != r.entries.end() ? it->second : db_entry();
+		const auto n_fe_missing = r.current.n_fe < (uint64_t)p.monitor->n_frame_errors ?
+		                          (uint64_t)p.monitor->n_frame_errors - r.current.n_fe : 0;
+
 		// display the performance (BER and FER) in real time (in a separate thread)
 		u.terminal->start_temp_report();
 
 		// run the simulation chain
-		while (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+		while (m.monitor->get_n_fe() < n_fe_missing && !u.terminal->is_interrupt())
 		{
 			(*m.source )[src::tsk::generate    ].exec();
 			(*m.encoder)[enc::tsk::encode      ].exec();
@@ -108,6 +213,9 @@ int main(int argc, char** argv)
 		// display the performance (BER and FER) in the terminal
 		u.terminal->final_report();
 
+		// add the frames of this run to the database
+		append_result(p, r, ebn0, *m.monitor);
+
 		// reset the monitor and the terminal for the next SNR
 		m.monitor->reset();
 		u.terminal->reset();
@@ -154,6 +262,81 @@ void init_params(int argc, char** argv, params &p)
 	p.R = (float)p.codec->enc->K / (float)p.codec->enc->N_cw; // compute the code rate
 }
 
+void init_results(params &p, results &r)
+{
+	r.hash   = 0;
+	r.n_runs = 0;
+	if (p.results_db.empty())
+		return;
+
+	// the key is the hash of the parameters displayed in the header, without the monitor and the terminal parameters:
+	// a run with a higher frame errors limit refines the results of the previous runs, the AFF3CT version is part of
+	// the key because another version of the modules may not give the same results
+	std::vector<factory::Factory::parameters*> params_list = { p.source.get(), p.codec.get(), p.modem.get(),
+	                                                           p.channel.get() };
+	std::stringstream header;
+	header << "v" << tools::version_major() << "." << tools::version_minor() << "." << tools::version_release() << "\n";
+	factory::Header::print_parameters(params_list, true, header);
+
+	// 64-bit FNV-1a hash
+	r.hash = 0xCBF29CE484222325ull;
+	for (auto c : header.str())
+	{
+		r.hash ^= (uint64_t)(unsigned char)c;
+		r.hash *= 0x100000001B3ull;
+	}
+
+	std::ifstream file(p.results_db, std::ios::in | std::ios::binary);
+	db_record rec;
+	while (file.read(reinterpret_cast<char*>(&rec), sizeof(rec)))
+		if (rec.hash == r.hash)
+		{
+			auto &e = r.entries[(int)std::round(rec.ebn0 * 1000.f)];
+			e.n_runs++;
+			e.n_frames += rec.n_frames;
+			e.n_be     += rec.n_be;
+			e.n_fe     += rec.n_fe;
+			r.n_runs    = std::max(r.n_runs, e.n_runs);
+		}
+
+	// the PRNGs of a new run have to produce new frames and new noise realizations, otherwise the same frames would be
+	// counted several times
+	p.source ->seed += (int)r.n_runs;
+	p.channel->seed += (int)r.n_runs;
+
+	std::cout << "# Results database: " << r.n_runs << " previous run(s) with the same parameters (" << p.results_db
+	          << ", key = " << std::hex << r.hash << std::dec << ")" << std::endl;
+	std::cout << "#" << std::endl;
+}
+
+void append_result(const params &p, const results &r, const float ebn0, const module::Monitor_BFER<> &monitor)
+{
+	if (p.results_db.empty() || !monitor.get_n_analyzed_fra())
+		return;
+
+	db_record rec;
+	rec.hash     = r.hash;
+	rec.ebn0     = ebn0;
+	rec.reserved = 0;
+	rec.n_frames = (uint64_t)monitor.get_n_analyzed_fra();
+	rec.n_be     = (uint64_t)monitor.get_n_be();
+	rec.n_fe     = (uint64_t)monitor.get_n_fe();
+
+	// the records are only appended, a run never rewrites the results of the previous runs: each record is written by
+	// a single 'write' on a file opened in append mode, the records of concurrent runs can't be interleaved
+#ifdef _WIN32
+	const int fd = _open(p.results_db.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+	const bool written = fd >= 0 && _write(fd, &rec, (unsigned)sizeof(rec)) == (int)sizeof(rec);
+	if (fd >= 0) _close(fd);
+#else
+	const int fd = open(p.results_db.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+	const bool written = fd >= 0 && write(fd, &rec, sizeof(rec)) == (ssize_t)sizeof(rec);
+	if (fd >= 0) close(fd);
+#endif
+	if (!written)
+		std::cerr << "# Warning: the results can't be added to the database (" << p.results_db << ")." << std::endl;
+}
+
 void init_modules(const params &p, modules &m)
 {
 	m.source  = std::unique_ptr<module::Source      <>>(p.source ->build());
@@ -193,7 +376,7 @@ void init_modules(const params &p, modules &m)
 	catch (const std::exception&) { /* do nothing if there is no interleaver */ }
 }
 
-void init_utils(const params &p, const modules &m, utils &u)
+void init_utils(const params &p, const modules &m, const results &r, utils &u)
 {
 	// create a sigma noise type
 	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
@@ -201,6 +384,9 @@ void init_utils(const params &p, const modules &m, utils &u)
 	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
 	// report the bit/frame error rates
 	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*m.monitor)));
+	// report the bit/frame error rates accumulated with the previous runs
+	if (!p.results_db.empty())
+		u.reporters.push_back(std::unique_ptr<tools::Reporter>(new Reporter_db(r.current, *m.monitor)));
 	// report the simulation throughputs
 	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*m.monitor)));
 	// create a terminal that will display the collected data from the reporters
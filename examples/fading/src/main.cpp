@@ -0,0 +1,401 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define FADING_MMAP
+#endif
+
+#ifdef _WIN32
+#include <process.h>
+#endif
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+struct params
+{
+	int         K          =  32;     // number of information bits
+	int         N          = 128;     // codeword size
+	int         fe         = 100;     // number of frame errors
+	int         seed       =   0;     // PRNG seed for the AWGN channel
+	float       ebn0_min   =   0.00f; // minimum SNR value
+	float       ebn0_max   =  20.01f; // maximum SNR value
+	float       ebn0_step  =   2.00f; // SNR step
+	float       R;                    // code rate (R=K/N)
+
+	float       rician_K   =   0.f;   // Rician K-factor: power of the line-of-sight path / power of the scattered paths
+	                                  // (0 = Rayleigh fading)
+	int         coherence  =   1;     // number of consecutive symbols with the same fading coefficient
+	std::string table_path = "";      // file of precomputed fading coefficients (empty = generate them for each frame)
+	size_t      table_size = 1 << 20; // number of coefficients in the file (when the file is created)
+};
+void init_params(params &p);
+
+// real fading gains applied to the modulated symbols (Y = H * X), the gains are generated by blocks of one frame from
+// the vectorized AFF3CT Gaussian generator or replayed from a precomputed file of coefficients
+class Channel_fading
+{
+protected:
+	const int   N;         // number of symbols per frame
+	const int   coherence; // number of consecutive symbols with the same coefficient
+	const int   n_coefs;   // number of coefficients per frame
+	const float rician_K;
+	const int   seed;
+
+	tools::Gaussian_noise_generator_fast<float> gaussian;
+	std::vector<float> I, Q;    // in-phase and quadrature components of the coefficients
+	std::vector<float> coefs;   // coefficients of the current frame
+
+	const float*       table;      // precomputed coefficients (mapped in memory or read from the file)
+	size_t             table_size;
+	std::vector<float> table_data; // storage of the table when it can't be mapped
+	void*              map_addr;
+	size_t             map_bytes;
+	uint64_t           frame;      // index of the frame in the current SNR point
+
+public:
+	Channel_fading(const int N, const int coherence, const float rician_K, const int seed,
+	               const std::string &table_path = "", const size_t table_size = 0)
+	: N(N), coherence(coherence), n_coefs((N + coherence -1) / coherence), rician_K(rician_K), seed(seed),
+	  gaussian(seed), I(n_coefs), Q(n_coefs), coefs(n_coefs), table(nullptr), table_size(0), map_addr(nullptr),
+	  map_bytes(0), frame(0)
+	{
+		if (!table_path.empty())
+			this->load_table(table_path, table_size);
+	}
+
+	~Channel_fading()
+	{
+#ifdef FADING_MMAP
+		if (this->map_addr != nullptr)
+			munmap(this->map_addr, this->map_bytes);
+#endif
+	}
+
+	// compute the gains of the frame in 'H_N' and the faded symbols in 'Y_N'
+	void apply(const std::vector<float> &X_N, std::vector<float> &H_N, std::vector<float> &Y_N)
+	{
+		const float* c;
+		if (this->table != nullptr)
+		{
+			// replay the table from the beginning of each SNR point, the realizations are the same for all the codes
+			const auto start = (size_t)((this->frame * (uint64_t)this->n_coefs) % (uint64_t)this->table_size);
+			if (start + this->n_coefs <= this->table_size)
+				c = this->table + start;
+			else
+			{
+				for (auto i = 0; i < this->n_coefs; i++)
+					this->coefs[i] = this->table[(start + i) % this->table_size];
+				c = this->coefs.data();
+			}
+		}
+		else
+		{
+			this->generate(this->coefs.data(), this->n_coefs);
+			c = this->coefs.data();
+		}
+
+		// block fading: a coefficient is reused for 'coherence' consecutive symbols
+		if (this->coherence == 1)
+			for (auto i = 0; i < this->N; i++)
+				H_N[i] = c[i];
+		else
+			for (auto i = 0; i < this->N; i++)
+				H_N[i] = c[i / this->coherence];
+
+		for (auto i = 0; i < this->N; i++)
+			Y_N[i] = H_N[i] * X_N[i];
+
+		this->frame++;
+	}
+
+	// restart the sequence of coefficients (called at the beginning of each SNR point)
+	void reset()
+	{
+		this->frame = 0;
+		this->gaussian.set_seed(this->seed);
+	}
+
+protected:
+	// amplitude of 'n' complex Gaussian coefficients with a unit average power
+	void generate(float *h, const int n)
+	{
+		const auto sigma = std::sqrt(1.f / (2.f * (this->rician_K + 1.f)));
+		const auto los   = std::sqrt(this->rician_K / (this->rician_K + 1.f));
+
+		this->gaussian.generate(this->I.data(), (unsigned)n, sigma, los);
+		this->gaussian.generate(this->Q.data(), (unsigned)n, sigma      );
+
+		const auto I = this->I.data();
+		const auto Q = this->Q.data();
+		for (auto i = 0; i < n; i++)
+			h[i] = std::sqrt(I[i] * I[i] + Q[i] * Q[i]);
+	}
+
+	void load_table(const std::string &path, const size_t table_size)
+	{
+		// the file starts with a "FAD1" magic, the K-factor and the number of coefficients (16 bytes, the
+		// coefficients stay aligned when the file is mapped)
+		struct header_t { char magic[4]; float rician_K; uint64_t n_coefs; } header;
+
+		if (!std::ifstream(path).good())
+		{
+			if (table_size < (size_t)this->n_coefs)
+			{
+				std::cerr << "# Error: the fading table has to contain at least one frame of coefficients." << std::endl;
+				std::exit(1);
+			}
+
+			// generate the table by blocks in a file specific to this process, the file is renamed at the end to never
+			// expose a partial table to the concurrent runs
+			std::stringstream tmp;
+#ifdef _WIN32
+			tmp << path << "." << _getpid() << ".tmp";
+#else
+			tmp << path << "." <<  getpid() << ".tmp";
+#endif
+			const auto tmp_path = tmp.str();
+			std::ofstream file(tmp_path, std::ios::out | std::ios::binary);
+			std::memcpy(header.magic, "FAD1", 4);
+			header.rician_K = this->rician_K;
+			header.n_coefs  = (uint64_t)table_size;
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			for (size_t i = 0; i < table_size; i += this->n_coefs)
+			{
+				const auto n = (int)std::min((size_t)this->n_coefs, table_size - i);
+				this->generate(this->coefs.data(), n);
+				file.write(reinterpret_cast<const char*>(this->coefs.data()), n * sizeof(float));
+			}
+			file.close();
+
+			// the rename fails on Windows when another run has already written the table, it is used instead
+			if (file.fail() || std::rename(tmp_path.c_str(), path.c_str()))
+			{
+				std::remove(tmp_path.c_str());
+				if (!std::ifstream(path).good())
+				{
+					std::cerr << "# Error: the fading table '" << path << "' can't be written." << std::endl;
+					std::exit(1);
+				}
+			}
+			this->gaussian.set_seed(this->seed);
+		}
+
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::strncmp(header.magic, "FAD1", 4) ||
+		    header.rician_K != this->rician_K || header.n_coefs < (uint64_t)this->n_coefs)
+		{
+			std::cerr << "# Error: the fading table '" << path << "' is invalid or has been generated with another "
+			          << "K-factor." << std::endl;
+			std::exit(1);
+		}
+
+		// a truncated table (e.g. the disk was full) would fault when the missing pages of the mapping are read
+		file.seekg(0, std::ios::end);
+		const auto file_size = (uint64_t)file.tellg();
+		if (!file || (file_size - sizeof(header)) / sizeof(float) < header.n_coefs)
+		{
+			std::cerr << "# Error: the fading table '" << path << "' is truncated (" << file_size << " bytes for "
+			          << header.n_coefs << " coefficients)." << std::endl;
+			std::exit(1);
+		}
+		file.seekg(sizeof(header), std::ios::beg);
+		this->table_size = (size_t)header.n_coefs;
+
+#ifdef FADING_MMAP
+		// map the file in memory: the pages are shared by all the processes which replay the same table
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			this->map_bytes = sizeof(header) + this->table_size * sizeof(float);
+			void* addr = mmap(nullptr, this->map_bytes, PROT_READ, MAP_SHARED, fd, 0);
+			close(fd);
+			if (addr != MAP_FAILED)
+			{
+				this->map_addr = addr;
+				this->table    = reinterpret_cast<const float*>(static_cast<const char*>(addr) + sizeof(header));
+				return;
+			}
+		}
+#endif
+		// read the whole file when it can't be mapped
+		this->table_data.resize(this->table_size);
+		if (!file.read(reinterpret_cast<char*>(this->table_data.data()), this->table_size * sizeof(float)))
+		{
+			std::cerr << "# Error: the fading table '" << path << "' can't be read." << std::endl;
+			std::exit(1);
+		}
+		this->table = this->table_data.data();
+	}
+};
+
+struct modules
+{
+	std::unique_ptr<module::Source_random<>>          source;
+	std::unique_ptr<module::Encoder_repetition_sys<>> encoder;
+	std::unique_ptr<module::Modem_BPSK<>>             modem;
+	std::unique_ptr<Channel_fading>                   fading;
+	std::unique_ptr<module::Channel_AWGN_LLR<>>       channel;
+	std::unique_ptr<module::Decoder_repetition_std<>> decoder;
+	std::unique_ptr<module::Monitor_BFER<>>           monitor;
+};
+void init_modules(const params &p, modules &m);
+
+struct buffers
+{
+	std::vector<int  > ref_bits;
+	std::vector<int  > enc_bits;
+	std::vector<float> symbols;
+	std::vector<float> H;             // fading gains
+	std::vector<float> faded_symbols;
+	std::vector<float> noisy_symbols;
+	std::vector<float> LLRs;
+	std::vector<int  > dec_bits;
+};
+void init_buffers(const params &p, buffers &b);
+
+struct utils
+{
+	std::unique_ptr<tools::Sigma<>>               noise;     // a sigma noise type
+	std::vector<std::unique_ptr<tools::Reporter>> reporters; // list of reporters dispayed in the terminal
+	std::unique_ptr<tools::Terminal_std>          terminal;  // manage the output text in the terminal
+};
+void init_utils(const modules &m, utils &u);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params p;  init_params (p   ); // create and initialize the parameters defined by the user
+	modules m; init_modules(p, m); // create and initialize the modules
+	buffers b; init_buffers(p, b); // create and initialize the buffers required by the modules
+	utils u;   init_utils  (m, u); // create and initialize the utils
+
+	// display the legend in the terminal
+	u.terminal->legend();
+
+	// loop over the various SNRs
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+	{
+		// compute the current sigma for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
+		const auto sigma = tools::esn0_to_sigma(esn0     );
+
+		u.noise->set_noise(sigma, ebn0, esn0);
+
+		// update the sigma of the modem and the channel
+		m.modem  ->set_noise(*u.noise);
+		m.channel->set_noise(*u.noise);
+
+		// display the performance (BER and FER) in real time (in a separate thread)
+		u.terminal->start_temp_report();
+
+		// run the simulation chain
+		while (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+		{
+			m.source ->generate     (                       b.ref_bits     );
+			m.encoder->encode       (b.ref_bits,            b.enc_bits     );
+			m.modem  ->modulate     (b.enc_bits,            b.symbols      );
+			m.fading ->apply        (b.symbols,        b.H, b.faded_symbols);
+			m.channel->add_noise    (b.faded_symbols,       b.noisy_symbols);
+			m.modem  ->demodulate_wg(b.H, b.noisy_symbols,  b.LLRs         );
+			m.decoder->decode_siho  (b.LLRs,                b.dec_bits     );
+			m.monitor->check_errors (b.dec_bits,            b.ref_bits     );
+		}
+
+		// display the performance (BER and FER) in the terminal
+		u.terminal->final_report();
+
+		// reset the monitor and the fading sequence for the next SNR
+		m.monitor->reset();
+		m.fading ->reset();
+		u.terminal->reset();
+
+		// if user pressed Ctrl+c twice, exit the SNRs loop
+		if (u.terminal->is_over()) break;
+	}
+
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+void init_params(params &p)
+{
+	p.R = (float)p.K / (float)p.N;
+	std::cout << "# * Simulation parameters: "               << std::endl;
+	std::cout << "#    ** Frame errors   = " << p.fe         << std::endl;
+	std::cout << "#    ** Noise seed     = " << p.seed       << std::endl;
+	std::cout << "#    ** Info. bits (K) = " << p.K          << std::endl;
+	std::cout << "#    ** Frame size (N) = " << p.N          << std::endl;
+	std::cout << "#    ** Code rate  (R) = " << p.R          << std::endl;
+	std::cout << "#    ** SNR min   (dB) = " << p.ebn0_min   << std::endl;
+	std::cout << "#    ** SNR max   (dB) = " << p.ebn0_max   << std::endl;
+	std::cout << "#    ** SNR step  (dB) = " << p.ebn0_step  << std::endl;
+	std::cout << "#    ** Rician K-factor= " << p.rician_K   << (p.rician_K > 0.f ? " (Rician)" : " (Rayleigh)") << std::endl;
+	std::cout << "#    ** Coherence      = " << p.coherence  << std::endl;
+	std::cout << "#    ** Fading table   = " << (p.table_path.empty() ? "no" : p.table_path)          << std::endl;
+	std::cout << "#"                                         << std::endl;
+}
+
+void init_modules(const params &p, modules &m)
+{
+	m.source  = std::unique_ptr<module::Source_random         <>>(new module::Source_random         <>(p.K        ));
+	m.encoder = std::unique_ptr<module::Encoder_repetition_sys<>>(new module::Encoder_repetition_sys<>(p.K, p.N   ));
+	m.modem   = std::unique_ptr<module::Modem_BPSK            <>>(new module::Modem_BPSK            <>(p.N        ));
+	m.fading  = std::unique_ptr<Channel_fading                  >(new Channel_fading(p.N, p.coherence, p.rician_K,
+	                                                                                 p.seed + 1, p.table_path,
+	                                                                                 p.table_size));
+	m.channel = std::unique_ptr<module::Channel_AWGN_LLR      <>>(new module::Channel_AWGN_LLR      <>(p.N, p.seed));
+	m.decoder = std::unique_ptr<module::Decoder_repetition_std<>>(new module::Decoder_repetition_std<>(p.K, p.N   ));
+	m.monitor = std::unique_ptr<module::Monitor_BFER          <>>(new module::Monitor_BFER          <>(p.K, p.fe  ));
+};
+
+void init_buffers(const params &p, buffers &b)
+{
+	b.ref_bits      = std::vector<int  >(p.K);
+	b.enc_bits      = std::vector<int  >(p.N);
+	b.symbols       = std::vector<float>(p.N);
+	b.H             = std::vector<float>(p.N);
+	b.faded_symbols = std::vector<float>(p.N);
+	b.noisy_symbols = std::vector<float>(p.N);
+	b.LLRs          = std::vector<float>(p.N);
+	b.dec_bits      = std::vector<int  >(p.K);
+}
+
+void init_utils(const modules &m, utils &u)
+{
+	// create a sigma noise type
+	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	// report the noise values (Es/N0 and Eb/N0)
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
+	// report the bit/frame error rates
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*m.monitor)));
+	// report the simulation throughputs
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*m.monitor)));
+	// create a terminal that will display the collected data from the reporters
+	u.terminal = std::unique_ptr<tools::Terminal_std>(new tools::Terminal_std(u.reporters));
+}
@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+struct params
+{
+	int   K         =  32;     // number of information bits
+	int   N         = 128;     // codeword size
+	int   fe        = 100;     // number of frame errors
+	int   seed      =   0;     // PRNG seed for the AWGN channel
+	float ebn0_min  =   0.00f; // minimum SNR value
+	float ebn0_max  =  10.01f; // maximum SNR value
+	float ebn0_step =   1.00f; // SNR step
+	float R;                   // code rate (R=K/N)
+
+	size_t      fe_capture      = 100;                // maximum number of captured frame errors (0 = disable the capture)
+	size_t      fe_capture_ring =  64;                // number of frames in the capture ring buffer
+	std::string fe_capture_path = "frame_errors.bin"; // binary file where the captured frames are written
+};
+void init_params(params &p);
+
+// copy of an erroneous frame
+struct Frame_error
+{
+	float              ebn0;
+	uint32_t           n_be;
+	uint64_t           frame;
+	std::vector<int  > ref_bits;
+	std::vector<float> LLRs;
+	std::vector<int  > dec_bits;
+};
+
+// single producer (the simulation thread) / single consumer (the writer thread) ring buffer of erroneous frames, the
+// producer never blocks: when the ring buffer is full the frame is dropped
+class Frame_error_capture
+{
+protected:
+	const int                K;
+	const int                N;
+	const size_t             max_frames;
+	std::vector<Frame_error> ring;
+	std::atomic<size_t>      head;       // number of frames pushed by the producer
+	std::atomic<size_t>      tail;       // number of frames written by the consumer
+	std::atomic<bool>        stop;
+	size_t                   n_captured;
+	size_t                   n_dropped;
+	std::ofstream            file;
+	std::thread              writer;
+
+public:
+	Frame_error_capture(const std::string &path, const int K, const int N, const size_t max_frames,
+	                    const size_t n_slots)
+	: K(K), N(N), max_frames(max_frames), ring(n_slots), head(0), tail(0), stop(false), n_captured(0), n_dropped(0),
+	  file(path, std::ios::out | std::ios::binary)
+	{
+		if (!file.is_open())
+		{
+			std::cerr << "# Error: the frame error capture file can't be opened ('" << path << "')." << std::endl;
+			std::exit(1);
+		}
+
+		// all the copies are done in preallocated buffers
+		for (auto &fe : ring)
+		{
+			fe.ref_bits.resize(K);
+			fe.LLRs    .resize(N);
+			fe.dec_bits.resize(K);
+		}
+
+		const uint32_t header[2] = { (uint32_t)K, (uint32_t)N };
+		file.write("FEC1", 4);
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+		writer = std::thread(&Frame_error_capture::write_loop, this);
+	}
+
+	~Frame_error_capture()
+	{
+		// the writer thread flushes the remaining frames before to exit
+		stop = true;
+		writer.join();
+	}
+
+	// called from the monitor on each frame error, return false if the frame has not been captured
+	bool capture(const float ebn0, const unsigned n_be, const uint64_t frame, const std::vector<int  > &ref_bits,
+	                                                                          const std::vector<float> &LLRs,
+	                                                                          const std::vector<int  > &dec_bits)
+	{
+		if (n_captured >= max_frames)
+			return false;
+
+		const auto h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) == ring.size())
+		{
+			n_dropped++;
+			return false;
+		}
+
+		auto &fe = ring[h % ring.size()];
+		fe.ebn0  = ebn0;
+		fe.n_be  = (uint32_t)n_be;
+		fe.frame = frame;
+		std::copy(ref_bits.begin(), ref_bits.begin() + K, fe.ref_bits.begin());
+		std::copy(LLRs    .begin(), LLRs    .begin() + N, fe.LLRs    .begin());
+		std::copy(dec_bits.begin(), dec_bits.begin() + K, fe.dec_bits.begin());
+
+		head.store(h +1, std::memory_order_release);
+		n_captured++;
+		return true;
+	}
+
+	size_t get_n_captured() const { return n_captured; }
+	size_t get_n_dropped () const { return n_dropped;  }
+
+protected:
+	void write_loop()
+	{
+		std::vector<char> bits((K + 7) / 8);
+		auto write_bits = [&](const std::vector<int> &v)
+		{
+			std::fill(bits.begin(), bits.end(), 0);
+			for (auto i = 0; i < K; i++)
+				bits[i / 8] |= (char)((v[i] & 1) << (i % 8));
+			file.write(bits.data(), bits.size());
+		};
+
+		auto t = tail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			// 'stop' is read before 'head': the last frames pushed before the stop are always written
+			const bool stopping = stop.load(std::memory_order_acquire);
+			const auto h        = head.load(std::memory_order_acquire);
+			if (t == h)
+			{
+				if (stopping)
+					break;
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				continue;
+			}
+
+			for (; t != h; t++)
+			{
+				const auto &fe = ring[t % ring.size()];
+				file.write(reinterpret_cast<const char*>(&fe.ebn0 ), sizeof(fe.ebn0 ));
+				file.write(reinterpret_cast<const char*>(&fe.n_be ), sizeof(fe.n_be ));
+				file.write(reinterpret_cast<const char*>(&fe.frame), sizeof(fe.frame));
+				write_bits(fe.ref_bits);
+				write_bits(fe.dec_bits);
+				file.write(reinterpret_cast<const char*>(fe.LLRs.data()), N * sizeof(float));
+
+				// the slot can be reused by the producer
+				tail.store(t +1, std::memory_order_release);
+			}
+			file.flush();
+		}
+	}
+};
+
+struct modules
+{
+	std::unique_ptr<module::Source_random<>>          source;
+	std::unique_ptr<module::Encoder_repetition_sys<>> encoder;
+	std::unique_ptr<module::Modem_BPSK<>>             modem;
+	std::unique_ptr<module::Channel_AWGN_LLR<>>       channel;
+	std::unique_ptr<module::Decoder_repetition_std<>> decoder;
+	std::unique_ptr<module::Monitor_BFER<>>           monitor;
+};
+void init_modules(const params &p, modules &m);
+
+struct buffers
+{
+	std::vector<int  > ref_bits;
+	std::vector<int  > enc_bits;
+	std::vector<float> symbols;
+	std::vector<float> noisy_symbols;
+	std::vector<float> LLRs;
+	std::vector<int  > dec_bits;
+};
+void init_buffers(const params &p, buffers &b);
+
+struct utils
+{
+	std::unique_ptr<tools::Sigma<>>               noise;     // a sigma noise type
+	std::vector<std::unique_ptr<tools::Reporter>> reporters; // list of reporters dispayed in the terminal
+	std::unique_ptr<tools::Terminal_std>          terminal;  // manage the output text in the terminal
+	std::unique_ptr<Frame_error_capture>          capture;   // copy the erroneous frames in a file (if enabled)
+};
+void init_utils(const params &p, const modules &m, utils &u);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params p;  init_params (p      ); // create and initialize the parameters defined by the user
+	modules m; init_modules(p, m   ); // create and initialize the modules
+	buffers b; init_buffers(p, b   ); // create and initialize the buffers required by the modules
+	utils u;   init_utils  (p, m, u); // create and initialize the utils
+
+	// copy the erroneous frames, the handler is called by the monitor after the frame has been checked
+	if (u.capture)
+		m.monitor->add_handler_fe([&m, &b, &u](unsigned n_be, int /*frame_id*/) -> void
+		{
+			u.capture->capture(u.noise->get_ebn0(), n_be, m.monitor->get_n_analyzed_fra(), b.ref_bits, b.LLRs,
+			                   b.dec_bits);
+		});
+
+	// display the legend in the terminal
+	u.terminal->legend();
+
+	// loop over the various SNRs
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+	{
+		// compute the current sigma for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
+		const auto sigma = tools::esn0_to_sigma(esn0     );
+
+		u.noise->set_noise(sigma, ebn0, esn0);
+
+		// update the sigma of the modem and the channel
+		m.modem  ->set_noise(*u.noise);
+		m.channel->set_noise(*u.noise);
+
+		// display the performance (BER and FER) in real time (in a separate thread)
+		u.terminal->start_temp_report();
+
+		// run the simulation chain
+		while (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+		{
+			m.source ->generate    (                 b.ref_bits     );
+			m.encoder->encode      (b.ref_bits,      b.enc_bits     );
+			m.modem  ->modulate    (b.enc_bits,      b.symbols      );
+			m.channel->add_noise   (b.symbols,       b.noisy_symbols);
+			m.modem  ->demodulate  (b.noisy_symbols, b.LLRs         );
+			m.decoder->decode_siho (b.LLRs,          b.dec_bits     );
+			m.monitor->check_errors(b.dec_bits,      b.ref_bits     );
+		}
+
+		// display the performance (BER and FER) in the terminal
+		u.terminal->final_report();
+
+		// reset the monitor for the next SNR
+		m.monitor->reset();
+		u.terminal->reset();
+
+		// if user pressed Ctrl+c twice, exit the SNRs loop
+		if (u.terminal->is_over()) break;
+	}
+
+	if (u.capture)
+	{
+		std::cout << "# Captured frame errors = " << u.capture->get_n_captured() << " (" << p.fe_capture_path << ")";
+		if (u.capture->get_n_dropped())
+			std::cout << ", dropped = " << u.capture->get_n_dropped() << " (the ring buffer was full)";
+		std::cout << std::endl;
+
+		// wait the writer thread
+		u.capture.reset();
+	}
+
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+void init_params(params &p)
+{
+	p.R = (float)p.K / (float)p.N;
+	std::cout << "# * Simulation parameters: "                    << std::endl;
+	std::cout << "#    ** Frame errors   = " << p.fe              << std::endl;
+	std::cout << "#    ** Noise seed     = " << p.seed            << std::endl;
+	std::cout << "#    ** Info. bits (K) = " << p.K               << std::endl;
+	std::cout << "#    ** Frame size (N) = " << p.N               << std::endl;
+	std::cout << "#    ** Code rate  (R) = " << p.R               << std::endl;
+	std::cout << "#    ** SNR min   (dB) = " << p.ebn0_min        << std::endl;
+	std::cout << "#    ** SNR max   (dB) = " << p.ebn0_max        << std::endl;
+	std::cout << "#    ** SNR step  (dB) = " << p.ebn0_step       << std::endl;
+	std::cout << "#    ** FE capture     = " << p.fe_capture      << std::endl;
+	std::cout << "#    ** FE ring size   = " << p.fe_capture_ring << std::endl;
+	std::cout << "#"                                              << std::endl;
+}
+
+void init_modules(const params &p, modules &m)
+{
+	m.source  = std::unique_ptr<module::Source_random         <>>(new module::Source_random         <>(p.K        ));
+	m.encoder = std::unique_ptr<module::Encoder_repetition_sys<>>(new module::Encoder_repetition_sys<>(p.K, p.N   ));
+	m.modem   = std::unique_ptr<module::Modem_BPSK            <>>(new module::Modem_BPSK            <>(p.N        ));
+	m.channel = std::unique_ptr<module::Channel_AWGN_LLR      <>>(new module::Channel_AWGN_LLR      <>(p.N, p.seed));
+	m.decoder = std::unique_ptr<module::Decoder_repetition_std<>>(new module::Decoder_repetition_std<>(p.K, p.N   ));
+	m.monitor = std::unique_ptr<module::Monitor_BFER          <>>(new module::Monitor_BFER          <>(p.K, p.fe  ));
+};
+
+void init_buffers(const params &p, buffers &b)
+{
+	b.ref_bits      = std::vector<int  >(p.K);
+	b.enc_bits      = std::vector<int  >(p.N);
+	b.symbols       = std::vector<float>(p.N);
+	b.noisy_symbols = std::vector<float>(p.N);
+	b.LLRs          = std::vector<float>(p.N);
+	b.dec_bits      = std::vector<int  >(p.K);
+}
+
+void init_utils(const params &p, const modules &m, utils &u)
+{
+	// create a sigma noise type
+	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	// report the noise values (Es/N0 and Eb/N0)
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
+	// report the bit/frame error rates
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*m.monitor)));
+	// report the simulation throughputs
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*m.monitor)));
+	// create a terminal that will display the collected data from the reporters
+	u.terminal = std::unique_ptr<tools::Terminal_std>(new tools::Terminal_std(u.reporters));
+	// create the frame error capture (start the writer thread)
+	if (p.fe_capture && p.fe_capture_ring)
+		u.capture = std::unique_ptr<Frame_error_capture>(new Frame_error_capture(p.fe_capture_path, p.K, p.N,
+		                                                                         p.fe_capture, p.fe_capture_ring));
+}
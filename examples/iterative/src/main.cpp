@@ -0,0 +1,362 @@
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+#include <interleaver_cache.hpp>
+
+struct params
+{
+	int   n_ite     =     10; // maximum number of iterations between the demodulator and the decoder
+	int   crc_start =      1; // first iteration where the CRC is checked (early termination)
+	float ebn0_min  =  0.00f; // minimum SNR value
+	float ebn0_max  = 10.01f; // maximum SNR value
+	float ebn0_step =  1.00f; // SNR step
+	float R;                  // code rate (R=K/N)
+	int   n_frames;           // number of frames processed in a batch
+	int   N_mod;              // number of symbols after the modulation
+
+	std::string itl_cache = ".itl_cache_"; // prefix of the interleaver LUT cache files (empty = disable the cache)
+
+	std::unique_ptr<factory::Source          ::parameters> source;
+	std::unique_ptr<factory::CRC             ::parameters> crc;
+	std::unique_ptr<factory::Codec_RSC       ::parameters> codec;
+	std::unique_ptr<factory::Interleaver_core::parameters> itl;
+	std::unique_ptr<factory::Modem           ::parameters> modem;
+	std::unique_ptr<factory::Channel         ::parameters> channel;
+	std::unique_ptr<factory::Monitor_BFER    ::parameters> monitor;
+	std::unique_ptr<factory::Terminal        ::parameters> terminal;
+};
+void init_params(int argc, char** argv, params &p);
+
+// count the number of decoding iterations of the frames
+struct Iteration_counter
+{
+	unsigned long long n_ite    = 0; // sum of the iterations of the frames
+	unsigned long long n_frames = 0; // number of decoded frames
+
+	void add  (const int ite) { this->n_ite += ite; this->n_frames++;   }
+	void reset(             ) { this->n_ite  = 0;   this->n_frames = 0; }
+};
+
+// report the average number of iterations per frame
+class Reporter_ite : public tools::Reporter
+{
+protected:
+	const Iteration_counter &counter;
+
+public:
+	explicit Reporter_ite(const Iteration_counter &counter)
+	: Reporter(), counter(counter)
+	{
+		title_t ite_title = {"Iterative decoding", ""};
+		std::vector<title_t> ite_cols = { {"AVG_ITE", ""} };
+		this->cols_groups.push_back(group_t(ite_title, ite_cols));
+	}
+
+	virtual ~Reporter_ite() = default;
+
+	report_t report(bool final = false)
+	{
+		const auto avg = this->counter.n_frames ? (double)this->counter.n_ite / (double)this->counter.n_frames : 0.;
+
+		std::stringstream ss_avg;
+		ss_avg << std::setprecision(2) << std::fixed << avg;
+
+		report_t report(this->cols_groups.size());
+		report[0] = { ss_avg.str() };
+		return report;
+	}
+};
+
+struct modules
+{
+	std::unique_ptr<module::Source<>>                 source;
+	std::unique_ptr<module::CRC<>>                    crc;
+	std::unique_ptr<module::Codec_SISO_SIHO<>>        codec;
+	std::unique_ptr<tools::Interleaver_core<>>        itl_core;
+	std::unique_ptr<module::Interleaver<int  >>       itl_bit;  // interleave the bits of the codeword
+	std::unique_ptr<module::Interleaver<float>>       itl_llr;  // interleave/deinterleave the LLRs of the codeword
+	std::unique_ptr<module::Modem<>>                  modem;
+	std::unique_ptr<module::Channel<>>                channel;
+	std::unique_ptr<module::Monitor_BFER<>>           monitor;
+	                module::Encoder<>*                encoder;
+	                module::Decoder_SISO<>*           decoder;
+};
+void init_modules(const params &p, modules &m);
+
+struct buffers
+{
+	std::vector<int  > ref_bits;       // information bits (K - CRC size)
+	std::vector<int  > crc_bits;       // information bits + CRC (K)
+	std::vector<int  > enc_bits;       // codeword (N)
+	std::vector<int  > itl_bits;       // interleaved codeword (N)
+	std::vector<float> symbols;        // modulated symbols (N_mod)
+	std::vector<float> noisy_symbols;  // symbols after the channel (N_mod)
+	std::vector<float> LLRs;           // demodulator output, interleaved order (N)
+	std::vector<float> LLRs_dec;       // demodulator output, codeword order (N)
+	std::vector<float> ext;            // extrinsic information of the decoder, codeword order (N)
+	std::vector<float> ext_itl;        // extrinsic information of the decoder, interleaved order (N)
+	std::vector<float> app;            // a posteriori information of the decoder (N)
+	std::vector<float> app_sys;        // a posteriori information of the systematic bits (K)
+	std::vector<int  > dec_crc_bits;   // decoded information bits + CRC (K)
+	std::vector<int  > dec_bits;       // decoded information bits (K - CRC size)
+};
+void init_buffers(const params &p, const modules &m, buffers &b);
+
+struct utils
+{
+	std::unique_ptr<tools::Sigma<>>               noise;     // a sigma noise type
+	Iteration_counter                             ite;       // count the decoding iterations
+	std::vector<std::unique_ptr<tools::Reporter>> reporters; // list of reporters dispayed in the terminal
+	std::unique_ptr<tools::Terminal>              terminal;  // manage the output text in the terminal
+};
+void init_utils(const params &p, const modules &m, utils &u);
+
+void decode_iterative(const params &p, modules &m, buffers &b, utils &u);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params  p; init_params (argc, argv, p); // create and initialize the parameters from the command line with factories
+	init_interleaver_cache(*p.itl, p.itl_cache); // generate the LUT once and reuse it from the disk afterward
+	modules m; init_modules(p, m         ); // create and initialize the modules
+	buffers b; init_buffers(p, m, b      ); // create and initialize the buffers required by the modules
+	utils   u; init_utils  (p, m, u      ); // create and initialize the utils
+
+	// display the legend in the terminal
+	u.terminal->legend();
+
+	// loop over the various SNRs
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+	{
+		// compute the current sigma for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R, p.modem->bps);
+		const auto sigma = tools::esn0_to_sigma(esn0, p.modem->upf     );
+
+		u.noise->set_noise(sigma, ebn0, esn0);
+
+		// update the sigma of the modem and the channel
+		m.codec  ->set_noise(*u.noise);
+		m.modem  ->set_noise(*u.noise);
+		m.channel->set_noise(*u.noise);
+
+		// display the performance (BER and FER) in real time (in a separate thread)
+		u.terminal->start_temp_report();
+
+		// run the simulation chain
+		while (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+		{
+			m.source ->generate  (                 b.ref_bits     );
+			m.crc    ->build     (b.ref_bits,      b.crc_bits     );
+			m.encoder->encode    (b.crc_bits,      b.enc_bits     );
+			m.itl_bit->interleave(b.enc_bits,      b.itl_bits     );
+			m.modem  ->modulate  (b.itl_bits,      b.symbols      );
+			m.channel->add_noise (b.symbols,       b.noisy_symbols);
+			m.modem  ->demodulate(b.noisy_symbols, b.LLRs         );
+
+			decode_iterative(p, m, b, u);
+
+			m.crc    ->extract     (b.dec_crc_bits, b.dec_bits);
+			m.monitor->check_errors(b.dec_bits,     b.ref_bits);
+		}
+
+		// display the performance (BER and FER) in the terminal
+		u.terminal->final_report();
+
+		// reset the monitor, the iteration counter and the terminal for the next SNR
+		m.monitor->reset();
+		u.ite.reset();
+		u.terminal->reset();
+
+		// if user pressed Ctrl+c twice, exit the SNRs loop
+		if (u.terminal->is_over()) break;
+	}
+
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+// iterate between the decoder and the demodulator, each frame stops as soon as its CRC is verified
+void decode_iterative(const params &p, modules &m, buffers &b, utils &u)
+{
+	const auto K = (int)b.dec_crc_bits.size() / p.n_frames;
+	const auto N = (int)b.LLRs        .size() / p.n_frames;
+
+	// list of the frames of the batch which have not converged yet
+	std::vector<int> active(p.n_frames);
+	for (auto f = 0; f < p.n_frames; f++)
+		active[f] = f;
+
+	for (auto ite = 1; ite <= p.n_ite && !active.empty(); ite++)
+	{
+		for (auto a = 0; a < (int)active.size(); a++)
+		{
+			const auto f = active[a];
+
+			// decode the frame, the output of the SISO decoder is the extrinsic information
+			m.itl_llr->deinterleave(b.LLRs,     b.LLRs_dec, f);
+			m.decoder->decode_siso (b.LLRs_dec, b.ext,      f);
+
+			// hard decision on the a posteriori information of the systematic bits
+			std::transform(b.LLRs_dec.begin() + f * N, b.LLRs_dec.begin() + (f + 1) * N, b.ext.begin() + f * N,
+			               b.app.begin() + f * N, std::plus<float>());
+			m.codec->extract_sys_llr(b.app, b.app_sys, f);
+			tools::hard_decide(b.app_sys.data() + f * K, b.dec_crc_bits.data() + f * K, K);
+
+			// the frame drops out of the next iterations if the CRC is verified or if it was the last iteration
+			const auto converged = ite >= p.crc_start && m.crc->check(b.dec_crc_bits, -1, f);
+			if (converged || ite == p.n_ite)
+			{
+				u.ite.add(ite);
+				active.erase(active.begin() + a--);
+				continue;
+			}
+
+			// demodulate again with the extrinsic information of the decoder as a priori information
+			m.itl_llr->interleave (b.ext,           b.ext_itl,  f);
+			m.modem  ->tdemodulate(b.noisy_symbols, b.ext_itl,  b.LLRs, f);
+		}
+	}
+}
+
+void init_params(int argc, char** argv, params &p)
+{
+	p.source   = std::unique_ptr<factory::Source          ::parameters>(new factory::Source          ::parameters());
+	p.crc      = std::unique_ptr<factory::CRC             ::parameters>(new factory::CRC             ::parameters());
+	p.codec    = std::unique_ptr<factory::Codec_RSC       ::parameters>(new factory::Codec_RSC       ::parameters());
+	p.itl      = std::unique_ptr<factory::Interleaver_core::parameters>(new factory::Interleaver_core::parameters());
+	p.modem    = std::unique_ptr<factory::Modem           ::parameters>(new factory::Modem           ::parameters());
+	p.channel  = std::unique_ptr<factory::Channel         ::parameters>(new factory::Channel         ::parameters());
+	p.monitor  = std::unique_ptr<factory::Monitor_BFER    ::parameters>(new factory::Monitor_BFER    ::parameters());
+	p.terminal = std::unique_ptr<factory::Terminal        ::parameters>(new factory::Terminal        ::parameters());
+
+	// the early termination requires a CRC
+	p.crc->type = "16-IBM";
+
+	// the a priori information of the decoder only helps a demodulator with several bits per symbol, the BPSK
+	// 'tdemodulate' ignores it: use a 16-QAM by default (can still be changed with '--mdm-type' and '--mdm-bps')
+	p.modem->type = "QAM";
+	p.modem->bps  = 4;
+
+	std::vector<factory::Factory::parameters*> params_list = { p.source .get(), p.crc    .get(), p.codec   .get(),
+	                                                           p.itl    .get(), p.modem  .get(), p.channel .get(),
+	                                                           p.monitor.get(), p.terminal.get()                   };
+
+	// parse the command for the given parameters and fill them
+	factory::Command_parser cp(argc, argv, params_list, true);
+	if (cp.parsing_failed())
+	{
+		cp.print_help    ();
+		cp.print_warnings();
+		cp.print_errors  ();
+		std::exit(1);
+	}
+
+	// the CRC bits are part of the K bits of the encoder
+	const auto K = p.codec->enc->K;
+	const auto N = p.codec->enc->N_cw;
+	p.crc    ->K = K - p.crc->size;
+	p.source ->K = K - p.crc->size;
+	p.monitor->K = K - p.crc->size;
+	p.itl    ->size = N;
+
+	// the modulation changes the number of symbols
+	p.N_mod = factory::Modem::get_buffer_size_after_modulation(p.modem->type, N, p.modem->bps, p.modem->upf,
+	                                                           p.modem->cpm_L);
+	p.modem  ->N = N;
+	p.channel->N = p.N_mod;
+
+	// all the modules process the same number of frames in a batch
+	p.n_frames = p.source->n_frames;
+	p.crc       ->n_frames = p.n_frames;
+	p.codec->enc->n_frames = p.n_frames;
+	p.codec->dec->n_frames = p.n_frames;
+	p.itl       ->n_frames = p.n_frames;
+	p.modem     ->n_frames = p.n_frames;
+	p.channel   ->n_frames = p.n_frames;
+	p.monitor   ->n_frames = p.n_frames;
+
+	std::cout << "# Simulation parameters: " << std::endl;
+	factory::Header::print_parameters(params_list); // display the headers (= print the AFF3CT parameters on the screen)
+	std::cout << "#" << std::endl;
+	cp.print_warnings();
+
+	p.R = (float)p.source->K / (float)N; // compute the code rate (the CRC bits are not information bits)
+}
+
+void init_modules(const params &p, modules &m)
+{
+	m.source   = std::unique_ptr<module::Source         <>>(p.source ->build());
+	m.crc      = std::unique_ptr<module::CRC            <>>(p.crc    ->build());
+	m.codec    = std::unique_ptr<module::Codec_SISO_SIHO<>>(p.codec  ->build());
+	m.itl_core = std::unique_ptr<tools::Interleaver_core<>>(factory::Interleaver_core::build<>(*p.itl));
+	m.itl_bit  = std::unique_ptr<module::Interleaver<int  >>(new module::Interleaver<int  >(*m.itl_core));
+	m.itl_llr  = std::unique_ptr<module::Interleaver<float>>(new module::Interleaver<float>(*m.itl_core));
+	m.modem    = std::unique_ptr<module::Modem          <>>(p.modem  ->build());
+	m.channel  = std::unique_ptr<module::Channel        <>>(p.channel->build());
+	m.monitor  = std::unique_ptr<module::Monitor_BFER   <>>(p.monitor->build());
+	m.encoder  = m.codec->get_encoder().get();
+	m.decoder  = m.codec->get_decoder_siso().get();
+
+	// initialize the bit interleaver
+	m.itl_core->init();
+}
+
+void init_buffers(const params &p, const modules &m, buffers &b)
+{
+	const auto K = p.codec->enc->K;
+	const auto N = p.codec->enc->N_cw;
+	const auto F = p.n_frames;
+
+	b.ref_bits      = std::vector<int  >(p.source->K * F);
+	b.crc_bits      = std::vector<int  >(K           * F);
+	b.enc_bits      = std::vector<int  >(N           * F);
+	b.itl_bits      = std::vector<int  >(N           * F);
+	b.symbols       = std::vector<float>(p.N_mod     * F);
+	b.noisy_symbols = std::vector<float>(p.N_mod     * F);
+	b.LLRs          = std::vector<float>(N           * F);
+	b.LLRs_dec      = std::vector<float>(N           * F);
+	b.ext           = std::vector<float>(N           * F);
+	b.ext_itl       = std::vector<float>(N           * F);
+	b.app           = std::vector<float>(N           * F);
+	b.app_sys       = std::vector<float>(K           * F);
+	b.dec_crc_bits  = std::vector<int  >(K           * F);
+	b.dec_bits      = std::vector<int  >(p.source->K * F);
+}
+
+void init_utils(const params &p, const modules &m, utils &u)
+{
+	// create a sigma noise type
+	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	// report the noise values (Es/N0 and Eb/N0)
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
+	// report the bit/frame error rates
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*m.monitor)));
+	// report the average number of iterations
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new Reporter_ite(u.ite)));
+	// report the simulation throughputs
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*m.monitor)));
+	// create a terminal that will display the collected data from the reporters
+	u.terminal = std::unique_ptr<tools::Terminal>(p.terminal->build(u.reporters));
+}
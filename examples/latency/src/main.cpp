@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+struct params
+{
+	int   K           =  32;     // number of information bits
+	int   N           = 128;     // codeword size
+	int   fe          = 100;     // number of frame errors
+	int   seed        =   0;     // PRNG seed for the AWGN channel
+	float ebn0_min    =   0.00f; // minimum SNR value
+	float ebn0_max    =  10.01f; // maximum SNR value
+	float ebn0_step   =   1.00f; // SNR step
+	float R;                     // code rate (R=K/N)
+
+	int   deadline_us =  20;     // per-frame latency deadline in microseconds
+	int   n_warmup    = 10000;   // number of frames simulated before the first measure (not reported)
+	int   cpu         =   0;     // CPU core where the simulation thread is pinned (-1 = no pinning)
+};
+void init_params(params &p);
+
+// histogram of the frame latencies (in nanoseconds) with log-linear buckets: the values below 128 ns are exact and the
+// other values are stored with a relative precision of 1/64, the recording never allocates memory
+class Latency_histogram
+{
+protected:
+	static const int n_sub = 64; // number of sub-buckets per power of two
+	std::vector<uint64_t> counts;
+	uint64_t n_frames;
+	uint64_t n_misses;
+	uint64_t max;
+	const uint64_t deadline;
+
+public:
+	explicit Latency_histogram(const uint64_t deadline_ns)
+	: counts(2 * n_sub + 57 * n_sub, 0), n_frames(0), n_misses(0), max(0), deadline(deadline_ns)
+	{
+	}
+
+	inline void record(const uint64_t ns)
+	{
+		counts[index(ns)]++;
+		n_frames++;
+		n_misses += ns > deadline ? 1 : 0;
+		max = std::max(max, ns);
+	}
+
+	// upper bound of the latency of the 'q' quantile of the frames (0 < q <= 1)
+	uint64_t quantile(const double q) const
+	{
+		if (!n_frames)
+			return 0;
+
+		const auto rank = std::max((uint64_t)1, (uint64_t)(q * (double)n_frames + 0.5));
+		uint64_t cumul = 0;
+		for (size_t i = 0; i < counts.size(); i++)
+		{
+			cumul += counts[i];
+			if (cumul >= rank)
+				return std::min(upper(i), max);
+		}
+		return max;
+	}
+
+	uint64_t get_n_frames() const { return n_frames; }
+	uint64_t get_n_misses() const { return n_misses; }
+	uint64_t get_max     () const { return max;      }
+	uint64_t get_deadline() const { return deadline; }
+
+	void reset()
+	{
+		std::fill(counts.begin(), counts.end(), 0);
+		n_frames = 0;
+		n_misses = 0;
+		max      = 0;
+	}
+
+protected:
+	static inline size_t index(const uint64_t ns)
+	{
+		if (ns < 2 * n_sub)
+			return (size_t)ns;
+
+		int shift = 1;
+		while ((ns >> shift) >= 2 * n_sub)
+			shift++;
+		return (size_t)(2 * n_sub + (shift -1) * n_sub + ((ns >> shift) - n_sub));
+	}
+
+	static inline uint64_t upper(const size_t idx)
+	{
+		if (idx < 2 * n_sub)
+			return (uint64_t)idx;
+
+		const auto shift = (int)((idx - 2 * n_sub) / n_sub) +1;
+		const auto sub   = (uint64_t)((idx - 2 * n_sub) % n_sub) + n_sub;
+		return ((sub +1) << shift) -1;
+	}
+};
+
+class Reporter_latency : public tools::Reporter
+{
+protected:
+	const Latency_histogram &histo;
+
+public:
+	explicit Reporter_latency(const Latency_histogram &histo)
+	: Reporter(), histo(histo)
+	{
+		title_t lat_title = {"Latency", "(us)"};
+		std::vector<title_t> lat_cols = { {"P50",   ""        },
+		                                  {"P99",   ""        },
+		                                  {"P99.9", ""        },
+		                                  {"MAX",   ""        },
+		                                  {"MISS",  "(frames)"} };
+		this->cols_groups.push_back(group_t(lat_title, lat_cols));
+	}
+
+	virtual ~Reporter_latency() = default;
+
+	report_t report(bool final = false)
+	{
+		auto us = [](const uint64_t ns)
+		{
+			std::stringstream ss;
+			ss << std::setprecision(2) << std::fixed << (double)ns * 1e-3;
+			return ss.str();
+		};
+
+		report_t report(this->cols_groups.size());
+		report[0] = { us(this->histo.quantile(0.5  )),
+		              us(this->histo.quantile(0.99 )),
+		              us(this->histo.quantile(0.999)),
+		              us(this->histo.get_max()      ),
+		              std::to_string(this->histo.get_n_misses()) };
+		return report;
+	}
+};
+
+struct modules
+{
+	std::unique_ptr<module::Source_random<>>          source;
+	std::unique_ptr<module::Encoder_repetition_sys<>> encoder;
+	std::unique_ptr<module::Modem_BPSK<>>             modem;
+	std::unique_ptr<module::Channel_AWGN_LLR<>>       channel;
+	std::unique_ptr<module::Decoder_repetition_std<>> decoder;
+	std::unique_ptr<module::Monitor_BFER<>>           monitor;
+	std::vector<const module::Module*>                list; // list of module pointers declared in this structure
+};
+void init_modules(const params &p, modules &m);
+
+struct utils
+{
+	std::unique_ptr<tools::Sigma<>>               noise;     // a sigma noise type
+	std::unique_ptr<Latency_histogram>            latencies; // latency of the frames of the current SNR
+	std::vector<std::unique_ptr<tools::Reporter>> reporters; // list of reporters dispayed in the terminal
+	std::unique_ptr<tools::Terminal_std>          terminal;  // manage the output text in the terminal
+};
+void init_utils(const params &p, const modules &m, utils &u);
+void init_realtime(const params &p, const modules &m);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params  p; init_params (p      ); // create and initialize the parameters defined by the user
+	modules m; init_modules(p, m   ); // create and initialize the modules
+	utils   u; init_utils  (p, m, u); // create and initialize the utils
+
+	// sockets binding (connect the sockets of the tasks = fill the input sockets with the output sockets)
+	using namespace module;
+	(*m.encoder)[enc::sck::encode      ::U_K ].bind((*m.source )[src::sck::generate   ::U_K ]);
+	(*m.modem  )[mdm::sck::modulate    ::X_N1].bind((*m.encoder)[enc::sck::encode     ::X_N ]);
+	(*m.channel)[chn::sck::add_noise   ::X_N ].bind((*m.modem  )[mdm::sck::modulate   ::X_N2]);
+	(*m.modem  )[mdm::sck::demodulate  ::Y_N1].bind((*m.channel)[chn::sck::add_noise  ::Y_N ]);
+	(*m.decoder)[dec::sck::decode_siho ::Y_N ].bind((*m.modem  )[mdm::sck::demodulate ::Y_N2]);
+	(*m.monitor)[mnt::sck::check_errors::U   ].bind((*m.encoder)[enc::sck::encode     ::U_K ]);
+	(*m.monitor)[mnt::sck::check_errors::V   ].bind((*m.decoder)[dec::sck::decode_siho::V_K ]);
+
+	// pin the simulation thread, lock and pre-fault the memory (the buffers are allocated by the tasks)
+	init_realtime(p, m);
+
+	// the chain of tasks executed for each frame
+	const std::vector<module::Task*> chain = { &(*m.source )[src::tsk::generate    ],
+	                                           &(*m.encoder)[enc::tsk::encode      ],
+	                                           &(*m.modem  )[mdm::tsk::modulate    ],
+	                                           &(*m.channel)[chn::tsk::add_noise   ],
+	                                           &(*m.modem  )[mdm::tsk::demodulate  ],
+	                                           &(*m.decoder)[dec::tsk::decode_siho ],
+	                                           &(*m.monitor)[mnt::tsk::check_errors] };
+
+	// display the legend in the terminal
+	u.terminal->legend();
+
+	// loop over the various SNRs
+	bool warmup = true;
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+	{
+		// compute the current sigma for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
+		const auto sigma = tools::esn0_to_sigma(esn0     );
+
+		u.noise->set_noise(sigma, ebn0, esn0);
+
+		// update the sigma of the modem and the channel
+		m.modem  ->set_noise(*u.noise);
+		m.channel->set_noise(*u.noise);
+
+		// warm up the caches, the branch predictors and the CPU frequency before the first measure
+		if (warmup)
+		{
+			for (auto f = 0; f < p.n_warmup; f++)
+				for (auto t : chain)
+					t->exec();
+			m.monitor->reset();
+			warmup = false;
+		}
+
+		// there is no real time report: the terminal thread would wake up during the measures
+		while (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+		{
+			const auto t_start = std::chrono::steady_clock::now();
+			for (auto t : chain)
+				t->exec();
+			const auto t_stop = std::chrono::steady_clock::now();
+
+			u.latencies->record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t_stop - t_start).count());
+		}
+
+		// display the performance (BER and FER) and the latencies in the terminal
+		u.terminal->final_report();
+
+		// reset the monitor, the latencies and the terminal for the next SNR
+		m.monitor->reset();
+		u.latencies->reset();
+		u.terminal->reset();
+
+		// if user pressed Ctrl+c twice, exit the SNRs loop
+		if (u.terminal->is_over()) break;
+	}
+
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+void init_params(params &p)
+{
+	p.R = (float)p.K / (float)p.N;
+	std::cout << "# * Simulation parameters: "                << std::endl;
+	std::cout << "#    ** Frame errors   = " << p.fe          << std::endl;
+	std::cout << "#    ** Noise seed     = " << p.seed        << std::endl;
+	std::cout << "#    ** Info. bits (K) = " << p.K           << std::endl;
+	std::cout << "#    ** Frame size (N) = " << p.N           << std::endl;
+	std::cout << "#    ** Code rate  (R) = " << p.R           << std::endl;
+	std::cout << "#    ** SNR min   (dB) = " << p.ebn0_min    << std::endl;
+	std::cout << "#    ** SNR max   (dB) = " << p.ebn0_max    << std::endl;
+	std::cout << "#    ** SNR step  (dB) = " << p.ebn0_step   << std::endl;
+	std::cout << "#    ** Deadline  (us) = " << p.deadline_us << std::endl;
+	std::cout << "#    ** Warm-up frames = " << p.n_warmup    << std::endl;
+	std::cout << "#    ** Pinned CPU     = " << p.cpu         << std::endl;
+	std::cout << "#"                                          << std::endl;
+}
+
+void init_modules(const params &p, modules &m)
+{
+	m.source  = std::unique_ptr<module::Source_random         <>>(new module::Source_random         <>(p.K        ));
+	m.encoder = std::unique_ptr<module::Encoder_repetition_sys<>>(new module::Encoder_repetition_sys<>(p.K, p.N   ));
+	m.modem   = std::unique_ptr<module::Modem_BPSK            <>>(new module::Modem_BPSK            <>(p.N        ));
+	m.channel = std::unique_ptr<module::Channel_AWGN_LLR      <>>(new module::Channel_AWGN_LLR      <>(p.N, p.seed));
+	m.decoder = std::unique_ptr<module::Decoder_repetition_std<>>(new module::Decoder_repetition_std<>(p.K, p.N   ));
+	m.monitor = std::unique_ptr<module::Monitor_BFER          <>>(new module::Monitor_BFER          <>(p.K, p.fe  ));
+
+	m.list = { m.source.get(), m.encoder.get(), m.modem.get(), m.channel.get(), m.decoder.get(), m.monitor.get() };
+
+	// configuration of the module tasks
+	for (auto& mod : m.list)
+		for (auto& tsk : mod->tasks)
+		{
+			tsk->set_autoalloc  (true ); // enable the automatic allocation of the data in the tasks
+			tsk->set_autoexec   (false); // disable the auto execution mode of the tasks
+			tsk->set_debug      (false); // disable the debug mode
+			tsk->set_debug_limit(16   ); // display only the 16 first bits if the debug mode is enabled
+			tsk->set_stats      (false); // disable the statistics, they add two clock reads per task
+
+			// enable the fast mode (= disable the useless verifs in the tasks) if there is no debug and stats modes
+			if (!tsk->is_debug() && !tsk->is_stats())
+				tsk->set_fast(true);
+		}
+}
+
+void init_utils(const params &p, const modules &m, utils &u)
+{
+	// create a sigma noise type
+	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	// create the latency histogram (the deadline is given in microseconds)
+	u.latencies = std::unique_ptr<Latency_histogram>(new Latency_histogram((uint64_t)p.deadline_us * 1000));
+	// report the noise values (Es/N0 and Eb/N0)
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
+	// report the bit/frame error rates
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*m.monitor)));
+	// report the latencies and the number of frames which missed the deadline
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new Reporter_latency(*u.latencies)));
+	// report the simulation throughputs
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*m.monitor)));
+	// create a terminal that will display the collected data from the reporters
+	u.terminal = std::unique_ptr<tools::Terminal_std>(new tools::Terminal_std(u.reporters));
+}
+
+void init_realtime(const params &p, const modules &m)
+{
+	// write the output socket buffers once, the pages are mapped before the first measured frame
+	for (auto& mod : m.list)
+		for (auto& tsk : mod->tasks)
+			for (auto& sck : tsk->sockets)
+				if (tsk->get_socket_type(*sck) != module::socket_t::SIN && sck->get_dataptr() != nullptr)
+					std::memset(sck->get_dataptr(), 0, sck->get_databytes());
+
+#ifdef __linux__
+	// lock the current and the future pages in RAM: no page fault and no swap during the measures
+	if (mlockall(MCL_CURRENT | MCL_FUTURE))
+		std::cerr << "# Warning: the memory can't be locked (see 'ulimit -l'), page faults may add latency."
+		          << std::endl;
+
+	// pin the simulation thread to avoid the migrations between the cores
+	if (p.cpu >= 0)
+	{
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(p.cpu, &cpuset);
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset))
+			std::cerr << "# Warning: the simulation thread can't be pinned on the CPU " << p.cpu << "." << std::endl;
+	}
+#else
+	std::cerr << "# Warning: the memory locking and the thread pinning are only supported on Linux." << std::endl;
+#endif
+}
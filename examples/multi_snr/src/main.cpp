@@ -0,0 +1,262 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+struct params
+{
+	int   K         =  32;     // number of information bits
+	int   N         = 128;     // codeword size
+	int   fe        = 100;     // number of frame errors
+	int   seed      =   0;     // PRNG seed for the AWGN channel
+	float ebn0_min  =   0.00f; // minimum SNR value
+	float ebn0_max  =  10.01f; // maximum SNR value
+	float ebn0_step =   1.00f; // SNR step
+	float R;                   // code rate (R=K/N)
+};
+void init_params(params &p);
+
+// report the throughput and the elapsed time of a branch from the start of the shared stream: all the branches count
+// frames from the first frame, even if their terminal starts later ('Reporter_throughput' starts its timer with the
+// terminal), and the time of a branch stops when it reaches the frame errors limit
+class Reporter_throughput_stream : public tools::Reporter
+{
+protected:
+	const module::Monitor_BFER<>                             &monitor;
+	const std::chrono::time_point<std::chrono::steady_clock> &t_start;
+	std::atomic<long long>                                    elapsed_stop; // elapsed time (us) at the end, 0 = running
+
+public:
+	Reporter_throughput_stream(const module::Monitor_BFER<> &monitor,
+	                           const std::chrono::time_point<std::chrono::steady_clock> &t_start)
+	: Reporter(), monitor(monitor), t_start(t_start), elapsed_stop(0)
+	{
+		title_t thr_title = {"Global throughput", "and elapsed time"};
+		std::vector<title_t> thr_cols = { {"SIM_THR", "(Mb/s)"  },
+		                                  {"ET/RT",   "(hhmmss)"} };
+		this->cols_groups.push_back(group_t(thr_title, thr_cols));
+	}
+
+	virtual ~Reporter_throughput_stream() = default;
+
+	// freeze the elapsed time when the branch stops simulating (it may be displayed later)
+	void stop()
+	{
+		this->elapsed_stop = std::max(1LL, (long long)this->get_elapsed());
+	}
+
+	report_t report(bool final = false)
+	{
+		const auto stop    = this->elapsed_stop.load();
+		const auto elapsed = stop ? stop : (long long)this->get_elapsed();
+		const auto n_bits  = (double)this->monitor.get_n_analyzed_fra() * this->monitor.get_K();
+		const auto thr     = elapsed > 0 ? n_bits / (double)elapsed : 0.; // bits/us = Mb/s
+
+		std::stringstream ss_thr, ss_et;
+		ss_thr << std::setprecision(3) << std::fixed << thr;
+		const auto s = elapsed / 1000000;
+		ss_et << std::setfill('0') << std::setw(2) << (s / 3600) << "h" << std::setw(2) << (s / 60) % 60 << "'"
+		      << std::setw(2) << s % 60;
+
+		report_t report(this->cols_groups.size());
+		report[0] = { ss_thr.str(), ss_et.str() };
+		return report;
+	}
+
+protected:
+	long long get_elapsed() const
+	{
+		const auto d = std::chrono::steady_clock::now() - this->t_start;
+		return (long long)std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+	}
+};
+
+// the modules and the utils which depend on the noise level, there is one branch per SNR
+struct branch
+{
+	std::unique_ptr<tools::Sigma<>>                   noise;      // the sigma noise type of this SNR
+	std::unique_ptr<module::Modem_BPSK<>>             modem;      // demodulate with the sigma of this SNR
+	std::unique_ptr<module::Channel_AWGN_LLR<>>       channel;
+	std::unique_ptr<module::Decoder_repetition_std<>> decoder;
+	std::unique_ptr<module::Monitor_BFER<>>           monitor;
+	std::vector<std::unique_ptr<tools::Reporter>>     reporters;  // list of reporters dispayed in the terminal
+	std::unique_ptr<tools::Terminal_std>              terminal;   // manage the output text in the terminal
+	Reporter_throughput_stream*                       throughput; // throughput reporter (stopped with the branch)
+};
+
+struct modules
+{
+	std::unique_ptr<module::Source_random<>>          source;
+	std::unique_ptr<module::Encoder_repetition_sys<>> encoder;
+	std::unique_ptr<module::Modem_BPSK<>>             modem;    // modulate only, does not depend on the noise
+	std::vector<branch>                               branches; // list of the branches (one per SNR)
+
+	std::chrono::time_point<std::chrono::steady_clock> t_start; // start of the shared stream (for all the branches)
+};
+void init_modules(const params &p, modules &m);
+
+struct buffers
+{
+	std::vector<int  >              ref_bits;
+	std::vector<int  >              enc_bits;
+	std::vector<float>              symbols;
+	std::vector<std::vector<float>> noisy_symbols; // one buffer per branch
+	std::vector<std::vector<float>> LLRs;          // one buffer per branch
+	std::vector<std::vector<int  >> dec_bits;      // one buffer per branch
+};
+void init_buffers(const params &p, const modules &m, buffers &b);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params  p; init_params (p      ); // create and initialize the parameters defined by the user
+	modules m; init_modules(p, m   ); // create and initialize the modules and the branches (one per SNR)
+	buffers b; init_buffers(p, m, b); // create and initialize the buffers required by the modules
+
+	// display the legend in the terminal (it is the same for all the branches)
+	m.branches[0].terminal->legend();
+
+	// the terminal displays the branches in the SNR order, the low SNRs reach the frame errors limit first
+	size_t cur = 0;
+
+	// all the branches simulate from the first frame, their throughput is computed from the start of the stream
+	m.t_start = std::chrono::steady_clock::now();
+
+	// display the performance (BER and FER) of the current branch in real time (in a separate thread)
+	m.branches[cur].terminal->start_temp_report();
+
+	// run the simulation chain until all the branches are done
+	while (cur < m.branches.size() && !m.branches[cur].terminal->is_interrupt())
+	{
+		// the source bits and the symbols do not depend on the noise, they are computed once for all the branches
+		m.source ->generate(            b.ref_bits);
+		m.encoder->encode  (b.ref_bits, b.enc_bits);
+		m.modem  ->modulate(b.enc_bits, b.symbols );
+
+		// fan out the symbols to the branches which have not reached the frame errors limit yet
+		for (size_t i = cur; i < m.branches.size(); i++)
+		{
+			auto &br = m.branches[i];
+			if (br.monitor->fe_limit_achieved())
+				continue;
+
+			br.channel->add_noise   (b.symbols,          b.noisy_symbols[i]);
+			br.modem  ->demodulate  (b.noisy_symbols[i], b.LLRs[i]         );
+			br.decoder->decode_siho (b.LLRs[i],          b.dec_bits[i]     );
+			br.monitor->check_errors(b.dec_bits[i],      b.ref_bits        );
+
+			if (br.monitor->fe_limit_achieved())
+				br.throughput->stop();
+		}
+
+		// display the performance (BER and FER) of the completed branches in the terminal, in the SNR order
+		while (cur < m.branches.size() && m.branches[cur].monitor->fe_limit_achieved())
+		{
+			m.branches[cur].terminal->final_report();
+			if (++cur < m.branches.size())
+				m.branches[cur].terminal->start_temp_report();
+		}
+	}
+
+	// the simulation has been interrupted by the user (Ctrl+c)
+	if (cur < m.branches.size())
+		m.branches[cur].terminal->final_report();
+
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+void init_params(params &p)
+{
+	p.R = (float)p.K / (float)p.N;
+	std::cout << "# * Simulation parameters: "              << std::endl;
+	std::cout << "#    ** Frame errors   = " << p.fe        << std::endl;
+	std::cout << "#    ** Noise seed     = " << p.seed      << std::endl;
+	std::cout << "#    ** Info. bits (K) = " << p.K         << std::endl;
+	std::cout << "#    ** Frame size (N) = " << p.N         << std::endl;
+	std::cout << "#    ** Code rate  (R) = " << p.R         << std::endl;
+	std::cout << "#    ** SNR min   (dB) = " << p.ebn0_min  << std::endl;
+	std::cout << "#    ** SNR max   (dB) = " << p.ebn0_max  << std::endl;
+	std::cout << "#    ** SNR step  (dB) = " << p.ebn0_step << std::endl;
+	std::cout << "#"                                        << std::endl;
+}
+
+void init_modules(const params &p, modules &m)
+{
+	m.source  = std::unique_ptr<module::Source_random         <>>(new module::Source_random         <>(p.K     ));
+	m.encoder = std::unique_ptr<module::Encoder_repetition_sys<>>(new module::Encoder_repetition_sys<>(p.K, p.N));
+	m.modem   = std::unique_ptr<module::Modem_BPSK            <>>(new module::Modem_BPSK            <>(p.N     ));
+	m.t_start = std::chrono::steady_clock::now();
+
+	// the branches are allocated first because the terminals keep a reference on the reporters of their branch
+	size_t n_branches = 0;
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+		n_branches++;
+	m.branches.resize(n_branches);
+
+	auto ebn0 = p.ebn0_min;
+	for (size_t i = 0; i < n_branches; i++, ebn0 += p.ebn0_step)
+	{
+		auto &br = m.branches[i];
+
+		// compute the sigma of this branch for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
+		const auto sigma = tools::esn0_to_sigma(esn0     );
+
+		br.noise   = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+		br.noise->set_noise(sigma, ebn0, esn0);
+
+		// each branch has its own channel seed, the noise realizations of two branches are independent
+		const int seed = p.seed + (int)i;
+
+		br.modem   = std::unique_ptr<module::Modem_BPSK            <>>(new module::Modem_BPSK            <>(p.N      ));
+		br.channel = std::unique_ptr<module::Channel_AWGN_LLR      <>>(new module::Channel_AWGN_LLR      <>(p.N, seed));
+		br.decoder = std::unique_ptr<module::Decoder_repetition_std<>>(new module::Decoder_repetition_std<>(p.K, p.N ));
+		br.monitor = std::unique_ptr<module::Monitor_BFER          <>>(new module::Monitor_BFER          <>(p.K, p.fe));
+
+		// update the sigma of the modem and the channel once and for all
+		br.modem  ->set_noise(*br.noise);
+		br.channel->set_noise(*br.noise);
+
+		// report the noise values (Es/N0 and Eb/N0)
+		br.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*br.noise)));
+		// report the bit/frame error rates
+		br.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*br.monitor)));
+		// report the simulation throughputs
+		br.throughput = new Reporter_throughput_stream(*br.monitor, m.t_start);
+		br.reporters.push_back(std::unique_ptr<tools::Reporter>(br.throughput));
+		// create a terminal that will display the collected data from the reporters
+		br.terminal = std::unique_ptr<tools::Terminal_std>(new tools::Terminal_std(br.reporters));
+	}
+};
+
+void init_buffers(const params &p, const modules &m, buffers &b)
+{
+	const auto n_branches = m.branches.size();
+
+	b.ref_bits      = std::vector<int  >(p.K);
+	b.enc_bits      = std::vector<int  >(p.N);
+	b.symbols       = std::vector<float>(p.N);
+	b.noisy_symbols = std::vector<std::vector<float>>(n_branches, std::vector<float>(p.N));
+	b.LLRs          = std::vector<std::vector<float>>(n_branches, std::vector<float>(p.N));
+	b.dec_bits      = std::vector<std::vector<int  >>(n_branches, std::vector<int  >(p.K));
+}
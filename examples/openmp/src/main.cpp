@@ -1,20 +1,37 @@
 #include <functional>
+#include <algorithm>
 #include <exception>
 #include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
 #include <cstdlib>
+#include <cstdio>
+#include <cstdint>
 #include <chrono>
+#include <atomic>
+#include <thread>
 #include <memory>
 #include <vector>
+#include <map>
 #include <string>
 
 #include <aff3ct.hpp>
 using namespace aff3ct;
 
+#include <interleaver_cache.hpp>
+
 #ifdef _OPENMP
 #include <omp.h>
 #else
-inline int omp_get_thread_num () { return 0; }
-inline int omp_get_num_threads() { return 1; }
+inline int  omp_get_thread_num () { return 0; }
+inline int  omp_get_num_threads() { return 1; }
+inline int  omp_get_max_threads() { return 1; }
+inline void omp_set_num_threads(int) {        }
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
 #endif
 
 struct params
@@ -24,6 +41,13 @@ struct params
 	float ebn0_step =  1.00f; // SNR step
 	float R;                  // code rate (R=K/N)
 
+	std::string itl_cache = "";            // prefix of the interleaver LUT cache files (empty = disable the cache), the
+	                                       // repetition codec has no interleaver: only useful with another codec
+	size_t      mem_budget = 0;             // memory budget in MB, limits the number of threads (0 = no limit,
+	                                        // set with '--mem-budget')
+	bool        deterministic = false;      // same results whatever the number of threads (frames seeded and reduced
+	                                        // in order, set with '--deterministic')
+
 	std::unique_ptr<factory::Source          ::parameters> source;
 	std::unique_ptr<factory::Codec_repetition::parameters> codec;
 	std::unique_ptr<factory::Modem           ::parameters> modem;
@@ -37,6 +61,130 @@ namespace aff3ct { namespace module {
 using Monitor_BFER_reduction = Monitor_reduction_M<Monitor_BFER<>>;
 } }
 
+// snapshot of the counters of a monitor published for the reporters, there is a single writer (the simulation thread
+// which owns the monitor) and the readers never write: the counters are stored with relaxed atomics in a seqlock and
+// the readers retry until they get a consistent copy, the writer never waits nor takes a lock
+struct Counters
+{
+	char                  pad0[64]; // the counters never share a cache line with the counters of another thread
+	std::atomic<uint32_t> seq;      // odd while the writer updates the counters
+	std::atomic<uint64_t> snr_id;   // index of the SNR of the counters
+	std::atomic<uint64_t> n_fra;
+	std::atomic<uint64_t> n_be;
+	std::atomic<uint64_t> n_fe;
+	char                  pad1[64];
+
+	Counters() : seq(0), snr_id(0), n_fra(0), n_be(0), n_fe(0) {}
+
+	void publish(const size_t snr_id, const module::Monitor_BFER<> &monitor)
+	{
+		const auto s = this->seq.load(std::memory_order_relaxed);
+		this->seq.store(s +1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		this->snr_id.store((uint64_t)snr_id,                      std::memory_order_relaxed);
+		this->n_fra .store((uint64_t)monitor.get_n_analyzed_fra(), std::memory_order_relaxed);
+		this->n_be  .store((uint64_t)monitor.get_n_be(),           std::memory_order_relaxed);
+		this->n_fe  .store((uint64_t)monitor.get_n_fe(),           std::memory_order_relaxed);
+		this->seq.store(s +2, std::memory_order_release);
+	}
+
+	void read(uint64_t &snr_id, uint64_t &n_fra, uint64_t &n_be, uint64_t &n_fe) const
+	{
+		uint32_t s0, s1;
+		do
+		{
+			s0     = this->seq   .load(std::memory_order_acquire);
+			snr_id = this->snr_id.load(std::memory_order_relaxed);
+			n_fra  = this->n_fra .load(std::memory_order_relaxed);
+			n_be   = this->n_be  .load(std::memory_order_relaxed);
+			n_fe   = this->n_fe  .load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			s1     = this->seq   .load(std::memory_order_relaxed);
+		}
+		while ((s0 & 1) || s0 != s1);
+	}
+};
+
+// display the BER/FER and the throughput from the published counters of the current SNR, replaces 'Reporter_BFER' and
+// 'Reporter_throughput' which read the monitors while the simulation threads update them
+class Reporter_snapshot : public tools::Reporter
+{
+protected:
+	const std::vector<const Counters*>                 counters;
+	const std::atomic<size_t>                         &snr_id;
+	const int                                          K;
+	std::chrono::time_point<std::chrono::steady_clock> t_start;
+
+public:
+	Reporter_snapshot(const std::vector<const Counters*> &counters, const std::atomic<size_t> &snr_id, const int K)
+	: Reporter(), counters(counters), snr_id(snr_id), K(K), t_start(std::chrono::steady_clock::now())
+	{
+		title_t bfer_title = {"Bit Error Rate (BER)", "and Frame Error Rate (FER)"};
+		std::vector<title_t> bfer_cols = { {"FRA", ""},
+		                                   {"BE",  ""},
+		                                   {"FE",  ""},
+		                                   {"BER", ""},
+		                                   {"FER", ""} };
+		this->cols_groups.push_back(group_t(bfer_title, bfer_cols));
+
+		title_t thr_title = {"Global throughput", "and elapsed time"};
+		std::vector<title_t> thr_cols = { {"SIM_THR", "(Mb/s)"  },
+		                                  {"ET/RT",   "(hhmmss)"} };
+		this->cols_groups.push_back(group_t(thr_title, thr_cols));
+	}
+
+	virtual ~Reporter_snapshot() = default;
+
+	// restart the elapsed time (at the beginning of each SNR)
+	void init()
+	{
+		this->t_start = std::chrono::steady_clock::now();
+	}
+
+	// sum the published counters of the current SNR, the counters of the threads which still simulate the previous SNR
+	// are not added
+	void sum(uint64_t &n_fra, uint64_t &n_be, uint64_t &n_fe) const
+	{
+		const auto cur_snr_id = (uint64_t)this->snr_id.load();
+		n_fra = 0; n_be = 0; n_fe = 0;
+		for (auto c : this->counters)
+		{
+			uint64_t c_snr_id, c_n_fra, c_n_be, c_n_fe;
+			c->read(c_snr_id, c_n_fra, c_n_be, c_n_fe);
+			if (c_snr_id != cur_snr_id)
+				continue;
+			n_fra += c_n_fra;
+			n_be  += c_n_be;
+			n_fe  += c_n_fe;
+		}
+	}
+
+	report_t report(bool final = false)
+	{
+		uint64_t n_fra, n_be, n_fe;
+		this->sum(n_fra, n_be, n_fe);
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+		                                                                           this->t_start).count();
+		const auto ber = n_fra ? (double)n_be / ((double)n_fra * this->K) : 0.;
+		const auto fer = n_fra ? (double)n_fe /  (double)n_fra            : 0.;
+		const auto thr = elapsed ? (double)n_fra * this->K / (double)elapsed : 0.; // bits/us = Mb/s
+
+		std::stringstream ss_ber, ss_fer, ss_thr, ss_et;
+		ss_ber << std::setprecision(2) << std::scientific << ber;
+		ss_fer << std::setprecision(2) << std::scientific << fer;
+		ss_thr << std::setprecision(3) << std::fixed      << thr;
+		const auto s = elapsed / 1000000;
+		ss_et << std::setfill('0') << std::setw(2) << (s / 3600) << "h" << std::setw(2) << (s / 60) % 60 << "'"
+		      << std::setw(2) << s % 60;
+
+		report_t report(this->cols_groups.size());
+		report[0] = { std::to_string(n_fra), std::to_string(n_be), std::to_string(n_fe), ss_ber.str(), ss_fer.str() };
+		report[1] = { ss_thr.str(), ss_et.str() };
+		return report;
+	}
+};
+
 struct utils
 {
 	std::unique_ptr<tools::Sigma<>>                      noise;         // a sigma noise type
@@ -46,8 +194,28 @@ struct utils
 	std::unique_ptr<module::Monitor_BFER_reduction>      monitor_red;   // main monitor object that reduce all the thread monitors
 	std::vector<std::vector<const module::Module*>>      modules;       // lists of the allocated modules
 	std::vector<std::vector<const module::Module*>>      modules_stats; // list of the allocated modules reorganized for the statistics
+	std::vector<float>                                   ebn0s;         // list of the simulated SNRs
+	std::atomic<size_t>                                  snr_id;        // index of the SNR currently simulated in 'ebn0s'
+	std::atomic<bool>                                    closing;       // true while a thread reports the current SNR
+	std::vector<std::atomic<size_t>>                     acks;          // index of the SNR simulated by each thread
+	std::vector<Counters>                                counters;      // counters of the thread monitors for the reporters
+	Reporter_snapshot*                                   reporter;      // reporter of the published counters
+
+	// deterministic mode: the frames are numbered in each SNR point and reduced in their order by 'monitor_ord'
+	std::atomic<uint64_t>                                frame_ticket;  // next frame to simulate (SNR index in the 16 MSBs)
+	std::unique_ptr<module::Monitor_BFER<>>              monitor_ord;   // monitor of the frames reduced in order
+	std::map<uint64_t, std::pair<std::vector<int>,
+	                             std::vector<int>>>      ord_pending;   // frames (U, V) waiting for the previous ones
+	std::atomic<uint64_t>                                ord_next;      // next frame to reduce in 'monitor_ord'
+	uint64_t                                             ord_window;    // max number of tickets ahead of 'ord_next'
+	size_t                                               ord_snr_id;    // SNR of the frames reduced in 'monitor_ord'
+	std::atomic<bool>                                    ord_done;      // the frame errors limit has been reached
+	Counters                                             counters_ord;  // counters of 'monitor_ord' for the reporters
 };
 void init_utils(const params &p, utils &u);
+bool all_threads_on(const utils &u, const size_t snr_id);
+void commit_frame(utils &u, const uint64_t ticket, const int *U, const int *V, const size_t size);
+int frame_seed(const int seed, const uint64_t frame);
 
 struct modules
 {
@@ -61,6 +229,11 @@ struct modules
 	std::vector<const module::Module*>      list; // list of module pointers declared in this structure
 };
 void init_modules_and_utils(const params &p, modules &m, utils &u);
+void init_threads(const params &p);
+size_t report_footprint(const std::vector<const module::Module*> &list, const size_t resident_bytes);
+void report_threads_footprint(const size_t thread_bytes, const size_t n_threads, const size_t max_threads,
+                              const size_t mem_budget);
+size_t get_resident_bytes();
 
 int main(int argc, char** argv)
 {
@@ -76,8 +249,14 @@ int main(int argc, char** argv)
 	std::cout << "#"                                                                << std::endl;
 
 	params p; init_params(argc, argv, p); // create and initialize the parameters from the command line with factories
+	if (p.codec->itl)                     // generate the interleaver LUT once for all the threads
+		init_interleaver_cache(*p.codec->itl->core, p.itl_cache);
+	init_threads(p);                      // fit the threads in the memory budget (if any)
 	utils u; // create an 'utils' structure
 
+	const auto t_init   = std::chrono::steady_clock::now();
+	const auto rss_init = get_resident_bytes();
+
 #pragma omp parallel
 {
 #pragma omp single
@@ -86,6 +265,8 @@ int main(int argc, char** argv)
 	const size_t n_threads = (size_t)omp_get_num_threads();
 	u.monitors.resize(n_threads);
 	u.modules .resize(n_threads);
+	u.acks = std::vector<std::atomic<size_t>>(n_threads);
+	u.counters = std::vector<Counters>(n_threads);
 }
 	modules m; init_modules_and_utils(p, m, u); // create and initialize the modules and initialize a part of the utils
 
@@ -94,8 +275,28 @@ int main(int argc, char** argv)
 {
 	init_utils(p, u); // finalize the utils initialization
 
+	const auto d_init = std::chrono::steady_clock::now() - t_init;
+	std::cout << "# Modules construction time = "
+	          << std::chrono::duration_cast<std::chrono::milliseconds>(d_init).count() << " ms" << std::endl;
+	std::cout << "#" << std::endl;
+
+	// report the memory footprint from the modules of the thread 0 (already reported by 'init_threads' with a budget),
+	// the resident memory of the threads is averaged (it also includes the thread stacks)
+	if (!p.mem_budget)
+	{
+		const auto n_threads = u.modules.size();
+		const auto rss_cur   = get_resident_bytes();
+		const auto resident  = rss_cur > rss_init ? (rss_cur - rss_init) / n_threads : 0;
+		const auto thread_bytes = report_footprint(u.modules[0], resident);
+		report_threads_footprint(thread_bytes, n_threads, (size_t)omp_get_max_threads(), p.mem_budget);
+	}
+
 	// display the legend in the terminal
 	u.terminal->legend();
+
+	// display the performance (BER and FER) of the first SNR in real time (in a separate thread)
+	if (!u.ebn0s.empty())
+		u.terminal->start_temp_report();
 }
 	// sockets binding (connect the sockets of the tasks = fill the input sockets with the output sockets)
 	using namespace module;
@@ -107,55 +308,187 @@ int main(int argc, char** argv)
 	(*m.monitor)[mnt::sck::check_errors::U   ].bind((*m.encoder)[enc::sck::encode     ::U_K ]);
 	(*m.monitor)[mnt::sck::check_errors::V   ].bind((*m.decoder)[dec::sck::decode_siho::V_K ]);
 
-	// loop over the various SNRs
-	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+	// each thread updates the noise of its own modules, the noise of the terminal is only updated by the thread which
+	// closes an SNR point (when the terminal does not display anything)
+	tools::Sigma<> noise;
+	auto set_noise = [&](const size_t snr_id)
 	{
 		// compute the current sigma for the channel noise
+		const auto ebn0  = u.ebn0s[snr_id];
 		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
 		const auto sigma = tools::esn0_to_sigma(esn0     );
-
-#pragma omp single
-		u.noise->set_noise(sigma, ebn0, esn0);
+		noise.set_noise(sigma, ebn0, esn0);
 
 		// update the sigma of the modem and the channel
-		m.codec  ->set_noise(*u.noise);
-		m.modem  ->set_noise(*u.noise);
-		m.channel->set_noise(*u.noise);
-
-#pragma omp single
-		// display the performance (BER and FER) in real time (in a separate thread)
-		u.terminal->start_temp_report();
+		m.codec  ->set_noise(noise);
+		m.modem  ->set_noise(noise);
+		m.channel->set_noise(noise);
+	};
+
+	// the threads, the modules and the buffers are kept alive for all the SNRs, there is no barrier between two SNRs:
+	// the thread which closes an SNR point publishes the next one and each thread switches to it after its current frame
+	const auto tid = (size_t)omp_get_thread_num();
+	auto snr_id = u.snr_id.load();
+	if (snr_id < u.ebn0s.size())
+		set_noise(snr_id);
+
+	auto switch_snr = [&](const size_t new_snr_id)
+	{
+		// the frames simulated since the final report belong to the previous SNR, drop them
+		m.monitor->reset();
+		snr_id = new_snr_id;
+		if (snr_id < u.ebn0s.size())
+			set_noise(snr_id);
+		if (!p.deterministic)
+			u.counters[tid].publish(snr_id, *m.monitor);
+		u.acks[tid] = snr_id; // from now, the monitor of this thread only counts the frames of the new SNR
+	};
+
+	// frames compared by the monitor (deterministic mode)
+	const auto U = static_cast<const int*>((*m.monitor)[mnt::sck::check_errors::U].get_dataptr());
+	const auto V = static_cast<const int*>((*m.monitor)[mnt::sck::check_errors::V].get_dataptr());
+	const auto frame_size = (size_t)(m.monitor->get_K() * m.monitor->get_n_frames());
+
+	while (snr_id < u.ebn0s.size())
+	{
+		// in the deterministic mode the PRNGs are seeded from the frame number: a frame gets the same source bits and
+		// the same noise whatever the thread which simulates it
+		uint64_t ticket = 0;
+		if (p.deterministic)
+		{
+			// the frames reduced out of order wait in 'ord_pending': no new ticket while a slow thread holds the frame
+			// to reduce and the window after it is full (until the limit is reached or the next SNR is published)
+			const auto next_ticket = u.frame_ticket.load();
+			if ((size_t)(next_ticket >> 48) == snr_id && !u.ord_done && !u.terminal->is_interrupt() &&
+			    (next_ticket & ((uint64_t(1) << 48) -1)) >= u.ord_next + u.ord_window)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			ticket = u.frame_ticket++;
+			const auto ticket_snr_id = (size_t)(ticket >> 48);
+			const auto frame         = ticket & ((uint64_t(1) << 48) -1);
+
+			// the ticket has been taken just before the next SNR was published
+			if (ticket_snr_id < snr_id)
+				continue;
+			if (ticket_snr_id > snr_id)
+			{
+				switch_snr(ticket_snr_id);
+				if (snr_id >= u.ebn0s.size())
+					break;
+			}
+
+			m.source ->set_seed(frame_seed(p.source ->seed, frame));
+			m.channel->set_seed(frame_seed(p.channel->seed, frame));
+		}
 
 		// run the simulation chain
-		while (!u.monitor_red->is_done_all() && !u.terminal->is_interrupt())
+		(*m.source )[src::tsk::generate    ].exec();
+		(*m.encoder)[enc::tsk::encode      ].exec();
+		(*m.modem  )[mdm::tsk::modulate    ].exec();
+		(*m.channel)[chn::tsk::add_noise   ].exec();
+		(*m.modem  )[mdm::tsk::demodulate  ].exec();
+		(*m.decoder)[dec::tsk::decode_siho ].exec();
+		(*m.monitor)[mnt::tsk::check_errors].exec();
+
+		if (p.deterministic)
+			commit_frame(u, ticket, U, V, frame_size);
+		else
+			// publish the counters of this thread for the reporters, only this thread writes in these cache lines
+			u.counters[tid].publish(snr_id, *m.monitor);
+
+		// another thread has published the next SNR
+		const auto cur_snr_id = u.snr_id.load();
+		if (cur_snr_id != snr_id)
 		{
-			(*m.source )[src::tsk::generate    ].exec();
-			(*m.encoder)[enc::tsk::encode      ].exec();
-			(*m.modem  )[mdm::tsk::modulate    ].exec();
-			(*m.channel)[chn::tsk::add_noise   ].exec();
-			(*m.modem  )[mdm::tsk::demodulate  ].exec();
-			(*m.decoder)[dec::tsk::decode_siho ].exec();
-			(*m.monitor)[mnt::tsk::check_errors].exec();
+			switch_snr(cur_snr_id);
+			continue;
 		}
 
-// need to wait all the threads here before to reset the 'monitors' and 'terminal' states
-#pragma omp barrier
-#pragma omp single
+		bool done;
+		if (p.deterministic)
+			// the frames are reduced in order by 'commit_frame', the monitors of the threads are not used
+			done = u.ord_done || u.terminal->is_interrupt();
+		else
+			// the reduction is meaningful only when all the monitors count the frames of the current SNR
+			done = (u.monitor_red->is_done_all() || u.terminal->is_interrupt()) && all_threads_on(u, snr_id);
+		if (!done)
+			continue;
+
+		// only one thread closes the current SNR point, the others keep simulating until the next SNR is published
+		bool closing = false;
+		if (!u.closing.compare_exchange_strong(closing, true))
+			continue;
+
+		// the SNR may have been closed and the next one published since the previous load
+		bool close = u.snr_id.load() == snr_id;
+
+		// the rate-limited reduction may come from before all the threads switched to this SNR (their monitors still
+		// counted the frames of the previous SNR): reduce again now that all the monitors count the frames of this SNR
+		// and keep simulating if the stop criterion is not met
+		if (close && !p.deterministic && !u.terminal->is_interrupt())
+			close = u.monitor_red->is_done_all(true);
+
+		// the reporters only read the published counters, they may lag behind the monitors (a thread publishes its
+		// counters after its frame): the point is reported once the published counters meet the stop criterion of the
+		// monitors (the frame errors limit or the frames limit, 0 = no frames limit)
+		if (close && !u.terminal->is_interrupt())
+		{
+			uint64_t n_fra, n_be, n_fe;
+			u.reporter->sum(n_fra, n_be, n_fe);
+			close = n_fe >= (uint64_t)p.monitor->n_frame_errors ||
+			        (p.monitor->max_frame && n_fra >= (uint64_t)p.monitor->max_frame);
+		}
+
+		if (close)
+		{
+			// display the performance (BER and FER) in the terminal, the reporters only read the published counters
+			u.terminal->final_report();
+
+			// reset the reduction monitor and the terminal for the next SNR, the thread monitors are reset by their
+			// own thread
+			u.monitor_red->reset();
+			u.terminal->reset();
+			u.reporter->init();
+
+			// if user pressed Ctrl+c twice, skip the remaining SNRs
+			const auto next_snr_id = u.terminal->is_over() ? u.ebn0s.size() : snr_id + 1;
+			if (next_snr_id < u.ebn0s.size())
+			{
+				const auto ebn0 = u.ebn0s[next_snr_id];
+				const auto esn0 = tools::ebn0_to_esn0(ebn0, p.R);
+				u.noise->set_noise(tools::esn0_to_sigma(esn0), ebn0, esn0);
+			}
+
+			// restart the ordered reduction from the first frame of the next SNR
+			if (p.deterministic)
+			{
+#pragma omp critical (ordered_reduction)
 {
-		// final reduction
-		u.monitor_red->is_done_all(true, true);
+				u.monitor_ord->reset();
+				u.ord_pending.clear();
+				u.ord_next   = 0;
+				u.ord_snr_id = next_snr_id;
+				u.ord_done   = false;
+				u.counters_ord.publish(next_snr_id, *u.monitor_ord);
+}
+			}
 
-		// display the performance (BER and FER) in the terminal
-		u.terminal->final_report();
+			// publish the next SNR to the other threads
+			u.snr_id       = next_snr_id;
+			u.frame_ticket = (uint64_t)next_snr_id << 48;
 
-		// reset the monitor and the terminal for the next SNR
-		u.monitor_red->reset_all();
-		u.terminal->reset();
-}
-		// if user pressed Ctrl+c twice, exit the SNRs loop
-		if (u.terminal->is_over()) break;
+			// display the performance (BER and FER) in real time (in a separate thread)
+			if (next_snr_id < u.ebn0s.size())
+				u.terminal->start_temp_report();
+		}
+		u.closing = false;
 	}
 
+// need to wait all the threads here before to display the statistics of their tasks
+#pragma omp barrier
 #pragma omp single
 {
 	// display the statistics of the tasks (if enabled)
@@ -179,10 +512,42 @@ void init_params(int argc, char** argv, params &p)
 	std::vector<factory::Factory::parameters*> params_list = { p.source .get(), p.codec  .get(), p.modem   .get(),
 	                                                           p.channel.get(), p.monitor.get(), p.terminal.get() };
 
+	// '--mem-budget' and '--deterministic' are specific to this example, they are removed from the arguments given to
+	// the AFF3CT parser
+	std::vector<char*> args;
+	for (auto i = 0; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--deterministic")
+		{
+			p.deterministic = true;
+			continue;
+		}
+
+		if (std::string(argv[i]) != "--mem-budget")
+		{
+			args.push_back(argv[i]);
+			continue;
+		}
+
+		char* end = nullptr;
+		const auto budget = i + 1 < argc ? std::strtoull(argv[i +1], &end, 10) : 0;
+		if (!end || *end != '\0' || end == argv[i +1])
+		{
+			std::cerr << "# (EE) '--mem-budget' expects a memory budget in MB (0 = no limit)." << std::endl;
+			std::exit(1);
+		}
+		p.mem_budget = (size_t)budget;
+		i++;
+	}
+
 	// parse the command for the given parameters and fill them
-	factory::Command_parser cp(argc, argv, params_list, true);
+	factory::Command_parser cp((int)args.size(), args.data(), params_list, true);
 	if (cp.parsing_failed())
 	{
+		std::cout << "# Example specific arguments:" << std::endl;
+		std::cout << "#    --mem-budget <MB>: memory budget, limits the number of threads (0 = no limit)" << std::endl;
+		std::cout << "#    --deterministic:   same results whatever the number of threads (frames reduced in order)"
+		          << std::endl;
 		cp.print_help    ();
 		cp.print_warnings();
 		cp.print_errors  ();
@@ -197,19 +562,111 @@ void init_params(int argc, char** argv, params &p)
 	p.R = (float)p.codec->enc->K / (float)p.codec->enc->N_cw; // compute the code rate
 }
 
+void init_threads(const params &p)
+{
+	// without a memory budget the footprint is reported from the modules of the thread 0 once they are built (see
+	// 'main'), the modules of one thread are only built here to know how many threads fit in the budget
+	if (!p.mem_budget)
+		return;
+
+	// the resident memory also includes the internal memory of the modules (decoder tables, interleaver LUT, ...)
+	const auto rss_before = get_resident_bytes();
+	size_t thread_bytes = 0;
+	{
+		utils u; u.monitors.resize(1); u.modules.resize(1);
+		modules m; init_modules_and_utils(p, m, u);
+		const auto rss_after = get_resident_bytes();
+		thread_bytes = report_footprint(m.list, rss_after > rss_before ? rss_after - rss_before : 0);
+	}
+
+	// each thread owns a full copy of the modules (the AFF3CT modules can't share their read-only tables), so the
+	// budget only limits the number of threads
+	const auto max_threads  = (size_t)omp_get_max_threads();
+	const auto budget_bytes = p.mem_budget * 1024 * 1024;
+	const auto n_fit        = budget_bytes / std::max((size_t)1, thread_bytes);
+	const auto n_threads    = std::max((size_t)1, std::min(max_threads, n_fit));
+	if (n_threads * thread_bytes > budget_bytes)
+		std::cerr << "# Warning: one thread does not fit in the memory budget (" << p.mem_budget << " MB)."
+		          << std::endl;
+	omp_set_num_threads((int)n_threads);
+
+	report_threads_footprint(thread_bytes, n_threads, max_threads, p.mem_budget);
+}
+
+size_t report_footprint(const std::vector<const module::Module*> &list, const size_t resident_bytes)
+{
+	// the socket buffers are allocated by the tasks
+	size_t sockets_bytes = 0;
+	std::cout << "# Memory footprint of one thread (output socket buffers):" << std::endl;
+	for (auto& mod : list)
+	{
+		size_t mod_bytes = 0;
+		for (auto& tsk : mod->tasks)
+			for (auto& sck : tsk->sockets)
+			{
+				// the input sockets are bound to the output sockets of the previous tasks, they do not own memory
+				if (tsk->get_socket_type(*sck) == module::socket_t::SIN)
+					continue;
+
+				std::cout << "#    ** " << std::setw(36) << std::left
+				          << (mod->get_name() + "::" + tsk->get_name() + "::" + sck->get_name())
+				          << " = " << std::setw(10) << std::right << sck->get_databytes() << " B" << std::endl;
+				mod_bytes += sck->get_databytes();
+			}
+		std::cout << "#    ** " << std::setw(36) << std::left << mod->get_name()
+		          << " = " << std::setw(10) << std::right << mod_bytes << " B (total)" << std::endl;
+		sockets_bytes += mod_bytes;
+	}
+
+	// the resident memory is not available on all the systems
+	std::cout << "#    ** " << std::setw(36) << std::left << "Sockets"
+	          << " = " << std::setw(10) << std::right << sockets_bytes << " B" << std::endl;
+	if (resident_bytes)
+		std::cout << "#    ** " << std::setw(36) << std::left << "Resident memory (modules + sockets)"
+		          << " = " << std::setw(10) << std::right << resident_bytes << " B" << std::endl;
+
+	return std::max(sockets_bytes, resident_bytes);
+}
+
+void report_threads_footprint(const size_t thread_bytes, const size_t n_threads, const size_t max_threads,
+                              const size_t mem_budget)
+{
+	std::cout << "# Memory footprint of " << n_threads << "/" << max_threads << " threads = "
+	          << (n_threads * thread_bytes) / (1024 * 1024) << " MB";
+	if (mem_budget)
+		std::cout << " (budget = " << mem_budget << " MB)";
+	std::cout << std::endl;
+	std::cout << "#" << std::endl;
+}
+
+size_t get_resident_bytes()
+{
+#ifdef __linux__
+	// the second field of 'statm' is the number of resident pages
+	size_t size = 0, resident = 0;
+	std::ifstream statm("/proc/self/statm");
+	if (statm >> size >> resident)
+		return resident * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+	return 0;
+}
+
 void init_modules_and_utils(const params &p, modules &m, utils &u)
 {
 	// get the thread id from OpenMP
 	const int tid = omp_get_thread_num();
 
-	// set different seeds for different threads when the module use a PRNG
-	p.source->seed += tid;
-	p.channel->seed += tid;
+	// set different seeds for different threads when the module use a PRNG, the parameters are shared by the threads
+	// so each thread works on its own copy
+	std::unique_ptr<factory::Source ::parameters> p_source (p.source ->clone());
+	std::unique_ptr<factory::Channel::parameters> p_channel(p.channel->clone());
+	p_source ->seed += tid;
+	p_channel->seed += tid;
 
-	m.source        = std::unique_ptr<module::Source      <>>(p.source ->build());
+	m.source        = std::unique_ptr<module::Source      <>>(p_source ->build());
 	m.codec         = std::unique_ptr<module::Codec_SIHO  <>>(p.codec  ->build());
 	m.modem         = std::unique_ptr<module::Modem       <>>(p.modem  ->build());
-	m.channel       = std::unique_ptr<module::Channel     <>>(p.channel->build());
+	m.channel       = std::unique_ptr<module::Channel     <>>(p_channel->build());
 	u.monitors[tid] = std::unique_ptr<module::Monitor_BFER<>>(p.monitor->build());
 	m.monitor       = u.monitors[tid].get();
 	m.encoder       = m.codec->get_encoder().get();
@@ -250,14 +707,42 @@ void init_utils(const params &p, utils &u)
 	// allocate a common monitor module to reduce all the monitors
 	u.monitor_red = std::unique_ptr<module::Monitor_BFER_reduction>(new module::Monitor_BFER_reduction(u.monitors));
 	u.monitor_red->set_reduce_frequency(std::chrono::milliseconds(500));
+	// allocate the monitor of the frames reduced in order (deterministic mode)
+	u.monitor_ord = std::unique_ptr<module::Monitor_BFER<>>(new module::Monitor_BFER<>(p.monitor->K,
+	                                                                                   p.monitor->n_frame_errors,
+	                                                                                   p.monitor->max_frame,
+	                                                                                   false, p.monitor->n_frames));
+	u.frame_ticket = 0;
+	u.ord_next     = 0;
+	u.ord_window   = 4 * u.acks.size();
+	u.ord_snr_id   = 0;
+	u.ord_done     = false;
+	// the reporters display the counters published by the threads or the counters of the frames reduced in order
+	std::vector<const Counters*> counters;
+	if (p.deterministic)
+		counters.push_back(&u.counters_ord);
+	else
+		for (auto &c : u.counters)
+			counters.push_back(&c);
+	// list the SNRs, all the threads start on the first one
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+		u.ebn0s.push_back(ebn0);
+	u.snr_id  = 0;
+	u.closing = false;
+	for (auto &ack : u.acks)
+		ack = 0;
 	// create a sigma noise type
 	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	if (!u.ebn0s.empty())
+	{
+		const auto esn0 = tools::ebn0_to_esn0(u.ebn0s[0], p.R);
+		u.noise->set_noise(tools::esn0_to_sigma(esn0), u.ebn0s[0], esn0);
+	}
 	// report the noise values (Es/N0 and Eb/N0)
 	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
-	// report the bit/frame error rates
-	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*u.monitor_red)));
-	// report the simulation throughputs
-	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*u.monitor_red)));
+	// report the bit/frame error rates and the simulation throughputs
+	u.reporter = new Reporter_snapshot(counters, u.snr_id, p.monitor->K);
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(u.reporter));
 	// create a terminal that will display the collected data from the reporters
 	u.terminal = std::unique_ptr<tools::Terminal>(p.terminal->build(u.reporters));
 
@@ -265,4 +750,51 @@ void init_utils(const params &p, utils &u)
 	for (size_t m = 0; m < u.modules[0].size(); m++)
 		for (size_t t = 0; t < u.modules.size(); t++)
 			u.modules_stats[m].push_back(u.modules[t][m]);
-}
\ No newline at end of file
+}
+bool all_threads_on(const utils &u, const size_t snr_id)
+{
+	for (auto &ack : u.acks)
+		if (ack != snr_id)
+			return false;
+	return true;
+}
+
+void commit_frame(utils &u, const uint64_t ticket, const int *U, const int *V, const size_t size)
+{
+	// the frames are numbered from 0 in each SNR, the SNR index is in the 16 MSBs of the ticket
+	const auto snr_id = (size_t)(ticket >> 48);
+	const auto frame  = ticket & ((uint64_t(1) << 48) -1);
+
+#pragma omp critical (ordered_reduction)
+{
+	// the frames of a closed SNR (still simulated when the next SNR was published) and the frames after the frame
+	// errors limit are dropped, 'ord_pending' only holds frames of the current SNR
+	if (snr_id == u.ord_snr_id && !u.ord_done)
+	{
+		auto &f = u.ord_pending[frame];
+		f.first .assign(U, U + size);
+		f.second.assign(V, V + size);
+
+		// reduce the frames in their order, up to the frame which reaches the frame errors or the frames limit
+		auto it = u.ord_pending.begin();
+		while (it != u.ord_pending.end() && it->first == u.ord_next && !u.ord_done)
+		{
+			u.monitor_ord->check_errors(it->second.first, it->second.second);
+			u.ord_done = u.monitor_ord->is_done();
+			u.ord_next++;
+			it = u.ord_pending.erase(it);
+		}
+		u.counters_ord.publish(snr_id, *u.monitor_ord);
+	}
+}
+}
+
+int frame_seed(const int seed, const uint64_t frame)
+{
+	// mix the seed and the frame number (splitmix64 finalizer), close frame numbers give uncorrelated seeds
+	uint64_t z = (uint64_t)(uint32_t)seed * 0x9E3779B97F4A7C15ull + frame + 1;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z =  z ^ (z >> 31);
+	return (int)(z & 0x7FFFFFFF);
+}
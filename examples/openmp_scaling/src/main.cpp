@@ -0,0 +1,453 @@
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include <aff3ct.hpp>
+using namespace aff3ct;
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+inline int omp_get_thread_num () { return 0; }
+inline int omp_get_num_threads() { return 1; }
+inline int omp_get_max_threads() { return 1; }
+#endif
+
+struct params
+{
+	float ebn0_min  = 0.00f; // minimum SNR value of the benchmark
+	float ebn0_max  = 4.01f; // maximum SNR value of the benchmark
+	float ebn0_step = 1.00f; // SNR step (each SNR point ends with a barrier and a single section)
+	float R;                 // code rate (R=K/N)
+
+	std::unique_ptr<factory::Source          ::parameters> source;
+	std::unique_ptr<factory::Codec_repetition::parameters> codec;
+	std::unique_ptr<factory::Modem           ::parameters> modem;
+	std::unique_ptr<factory::Channel         ::parameters> channel;
+	std::unique_ptr<factory::Monitor_BFER    ::parameters> monitor;
+	std::unique_ptr<factory::Terminal        ::parameters> terminal;
+};
+void init_params(int argc, char** argv, params &p);
+
+namespace aff3ct { namespace module {
+using Monitor_BFER_reduction = Monitor_reduction_M<Monitor_BFER<>>;
+} }
+
+// measure the time spent in the 'report' method of a reporter, this method is called by the terminal thread
+class Reporter_timed : public tools::Reporter
+{
+protected:
+	tools::Reporter          &reporter;
+	std::chrono::nanoseconds  duration;
+
+public:
+	explicit Reporter_timed(tools::Reporter &reporter)
+	: Reporter(), reporter(reporter), duration(0)
+	{
+		this->cols_groups = reporter.get_groups();
+	}
+
+	virtual ~Reporter_timed() = default;
+
+	report_t report(bool final = false)
+	{
+		const auto t_start = std::chrono::steady_clock::now();
+		auto r = this->reporter.report(final);
+		this->duration += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t_start);
+		return r;
+	}
+
+	void init()
+	{
+		this->reporter.init();
+	}
+
+	std::chrono::nanoseconds get_duration() const
+	{
+		return this->duration;
+	}
+};
+
+// time spent by a simulation thread in the different parts of the chain
+struct timers
+{
+	std::chrono::nanoseconds chain       = std::chrono::nanoseconds(0); // execution of the tasks
+	std::chrono::nanoseconds is_done_all = std::chrono::nanoseconds(0); // calls to 'Monitor_reduction_M::is_done_all'
+	std::chrono::nanoseconds barrier     = std::chrono::nanoseconds(0); // '#pragma omp barrier' at the end of each SNR
+	std::chrono::nanoseconds single      = std::chrono::nanoseconds(0); // '#pragma omp single' final reduction + report
+
+	timers& operator+=(const timers &t)
+	{
+		this->chain       += t.chain;
+		this->is_done_all += t.is_done_all;
+		this->barrier     += t.barrier;
+		this->single      += t.single;
+		return *this;
+	}
+};
+
+// benchmark result for a given number of threads
+struct result
+{
+	int                      n_threads;  // number of threads granted by OpenMP
+	int                      n_snrs;     // number of simulated SNR points
+	double                   t_wall;     // simulation time in seconds
+	double                   throughput; // information throughput in Mb/s
+	timers                   t;          // sum of the thread timers
+	std::chrono::nanoseconds reporter;   // time spent in the reporters by the terminal thread
+};
+void display_results(const std::vector<result> &results);
+
+struct utils
+{
+	std::unique_ptr<tools::Sigma<>>                      noise;           // a sigma noise type
+	std::vector<std::unique_ptr<tools::Reporter>>        reporters;       // list of reporters
+	std::vector<std::unique_ptr<tools::Reporter>>        reporters_timed; // the same reporters with a time measurement
+	std::unique_ptr<tools::Terminal>                     terminal;        // manage the output text in the terminal
+	std::vector<std::unique_ptr<module::Monitor_BFER<>>> monitors;        // list of the monitors from all the threads
+	std::unique_ptr<module::Monitor_BFER_reduction>      monitor_red;     // main monitor object that reduce all the thread monitors
+	std::vector<timers>                                  times;           // time measurements of each thread
+	unsigned long long                                   n_frames = 0;    // frames simulated over all the SNR points
+};
+void init_utils(const params &p, utils &u);
+
+struct modules
+{
+	std::unique_ptr<module::Source<>>       source;
+	std::unique_ptr<module::Codec_SIHO<>>   codec;
+	std::unique_ptr<module::Modem<>>        modem;
+	std::unique_ptr<module::Channel<>>      channel;
+	                module::Monitor_BFER<>* monitor;
+	                module::Encoder<>*      encoder;
+	                module::Decoder_SIHO<>* decoder;
+	std::vector<const module::Module*>      list; // list of module pointers declared in this structure
+};
+void init_modules_and_utils(const params &p, modules &m, utils &u);
+
+int main(int argc, char** argv)
+{
+	// get the AFF3CT version
+	const std::string v = "v" + std::to_string(tools::version_major()) + "." +
+	                            std::to_string(tools::version_minor()) + "." +
+	                            std::to_string(tools::version_release());
+
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "# This is a basic program using the AFF3CT library (" << v << ")" << std::endl;
+	std::cout << "# Feel free to improve it as you want to fit your needs."         << std::endl;
+	std::cout << "#----------------------------------------------------------"      << std::endl;
+	std::cout << "#"                                                                << std::endl;
+
+	params p; init_params(argc, argv, p); // create and initialize the parameters from the command line with factories
+
+	// list the SNRs, the same SNRs are simulated for all the thread counts
+	std::vector<float> ebn0s;
+	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+		ebn0s.push_back(ebn0);
+
+	// list of the benchmarked numbers of threads: 1, 2, 4, ..., max
+	const int max_threads = omp_get_max_threads();
+	std::vector<int> thread_counts;
+	for (auto n = 1; n < max_threads; n *= 2)
+		thread_counts.push_back(n);
+	thread_counts.push_back(max_threads);
+
+	std::vector<result> results;
+	for (auto n_threads : thread_counts)
+	{
+		utils u; // create an 'utils' structure
+
+		std::chrono::steady_clock::time_point t_start, t_stop;
+		bool interrupted = false;
+		int n_granted = 0;
+		size_t n_snrs = 0;
+
+#pragma omp parallel num_threads(n_threads)
+{
+#pragma omp single
+{
+	// OpenMP may grant less threads than requested (dynamic adjustment, thread limit)
+	n_granted = omp_get_num_threads();
+	u.monitors.resize(n_granted);
+	u.times   .resize(n_granted);
+}
+	modules m; init_modules_and_utils(p, m, u); // create and initialize the modules and initialize a part of the utils
+
+#pragma omp barrier
+#pragma omp single
+{
+	init_utils(p, u); // finalize the utils initialization
+
+	// display the legend in the terminal
+	if (n_threads == thread_counts[0])
+		u.terminal->legend();
+}
+	// sockets binding (connect the sockets of the tasks = fill the input sockets with the output sockets)
+	using namespace module;
+	(*m.encoder)[enc::sck::encode      ::U_K ].bind((*m.source )[src::sck::generate   ::U_K ]);
+	(*m.modem  )[mdm::sck::modulate    ::X_N1].bind((*m.encoder)[enc::sck::encode     ::X_N ]);
+	(*m.channel)[chn::sck::add_noise   ::X_N ].bind((*m.modem  )[mdm::sck::modulate   ::X_N2]);
+	(*m.modem  )[mdm::sck::demodulate  ::Y_N1].bind((*m.channel)[chn::sck::add_noise  ::Y_N ]);
+	(*m.decoder)[dec::sck::decode_siho ::Y_N ].bind((*m.modem  )[mdm::sck::demodulate ::Y_N2]);
+	(*m.monitor)[mnt::sck::check_errors::U   ].bind((*m.encoder)[enc::sck::encode     ::U_K ]);
+	(*m.monitor)[mnt::sck::check_errors::V   ].bind((*m.decoder)[dec::sck::decode_siho::V_K ]);
+
+	auto &t = u.times[omp_get_thread_num()];
+
+	// loop over the SNRs, each SNR point ends with a barrier and a single section as in the barrier-based chain
+	for (size_t s = 0; s < ebn0s.size(); s++)
+	{
+// the construction of the modules is not part of the measured time
+#pragma omp single
+{
+		// compute the current sigma for the channel noise
+		const auto esn0  = tools::ebn0_to_esn0 (ebn0s[s], p.R);
+		const auto sigma = tools::esn0_to_sigma(esn0         );
+		u.noise->set_noise(sigma, ebn0s[s], esn0);
+
+		// display the performance (BER and FER) in real time (in a separate thread)
+		u.terminal->start_temp_report();
+		if (s == 0)
+			t_start = std::chrono::steady_clock::now();
+}
+		// update the sigma of the modem and the channel
+		m.codec  ->set_noise(*u.noise);
+		m.modem  ->set_noise(*u.noise);
+		m.channel->set_noise(*u.noise);
+
+		// run the simulation chain
+		while (true)
+		{
+			const auto t_done = std::chrono::steady_clock::now();
+			const auto done = u.monitor_red->is_done_all() || u.terminal->is_interrupt();
+			const auto t_exec = std::chrono::steady_clock::now();
+			t.is_done_all += std::chrono::duration_cast<std::chrono::nanoseconds>(t_exec - t_done);
+
+			if (done) break;
+
+			(*m.source )[src::tsk::generate    ].exec();
+			(*m.encoder)[enc::tsk::encode      ].exec();
+			(*m.modem  )[mdm::tsk::modulate    ].exec();
+			(*m.channel)[chn::tsk::add_noise   ].exec();
+			(*m.modem  )[mdm::tsk::demodulate  ].exec();
+			(*m.decoder)[dec::tsk::decode_siho ].exec();
+			(*m.monitor)[mnt::tsk::check_errors].exec();
+
+			t.chain += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t_exec);
+		}
+
+		const auto t_barrier = std::chrono::steady_clock::now();
+// need to wait all the threads here before the final reduction
+#pragma omp barrier
+		const auto t_single = std::chrono::steady_clock::now();
+		t.barrier += std::chrono::duration_cast<std::chrono::nanoseconds>(t_single - t_barrier);
+
+// the time of the waiting threads is measured up to the implicit barrier at the end of the section
+#pragma omp single
+{
+		t_stop = std::chrono::steady_clock::now();
+
+		// final reduction
+		u.monitor_red->is_done_all(true, true);
+
+		// display the performance (BER and FER) in the terminal
+		u.terminal->final_report();
+
+		// reset the monitors and the terminal for the next SNR
+		u.n_frames += u.monitor_red->get_n_analyzed_fra();
+		u.monitor_red->reset_all();
+		u.terminal->reset();
+		n_snrs = s + 1;
+
+		interrupted = u.terminal->is_interrupt();
+}
+		t.single += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t_single);
+
+		// if user pressed Ctrl+c, skip the remaining SNRs (all the threads read the flag after the single section)
+		if (interrupted) break;
+	}
+}
+		result r;
+		r.n_threads  = n_granted;
+		r.n_snrs     = (int)n_snrs;
+		r.t_wall     = std::chrono::duration<double>(t_stop - t_start).count();
+		r.throughput = ((double)u.n_frames * (double)p.codec->enc->K) / (r.t_wall * 1e6);
+		r.reporter   = std::chrono::nanoseconds(0);
+		for (auto &tt : u.times)
+			r.t += tt;
+		for (auto &rep : u.reporters_timed)
+			r.reporter += static_cast<Reporter_timed&>(*rep).get_duration();
+		results.push_back(r);
+
+		if (n_granted != n_threads)
+			std::cerr << "# Warning: " << n_threads << " threads requested, OpenMP granted " << n_granted << "."
+			          << std::endl;
+
+		// if user pressed Ctrl+c, stop the benchmark
+		if (interrupted) break;
+	}
+
+	display_results(results);
+	std::cout << "# End of the simulation" << std::endl;
+
+	return 0;
+}
+
+void init_params(int argc, char** argv, params &p)
+{
+	p.source   = std::unique_ptr<factory::Source          ::parameters>(new factory::Source          ::parameters());
+	p.codec    = std::unique_ptr<factory::Codec_repetition::parameters>(new factory::Codec_repetition::parameters());
+	p.modem    = std::unique_ptr<factory::Modem           ::parameters>(new factory::Modem           ::parameters());
+	p.channel  = std::unique_ptr<factory::Channel         ::parameters>(new factory::Channel         ::parameters());
+	p.monitor  = std::unique_ptr<factory::Monitor_BFER    ::parameters>(new factory::Monitor_BFER    ::parameters());
+	p.terminal = std::unique_ptr<factory::Terminal        ::parameters>(new factory::Terminal        ::parameters());
+
+	std::vector<factory::Factory::parameters*> params_list = { p.source .get(), p.codec  .get(), p.modem   .get(),
+	                                                           p.channel.get(), p.monitor.get(), p.terminal.get() };
+
+	// parse the command for the given parameters and fill them
+	factory::Command_parser cp(argc, argv, params_list, true);
+	if (cp.parsing_failed())
+	{
+		cp.print_help    ();
+		cp.print_warnings();
+		cp.print_errors  ();
+		std::exit(1);
+	}
+
+	std::cout << "# Simulation parameters: " << std::endl;
+	factory::Header::print_parameters(params_list); // display the headers (= print the AFF3CT parameters on the screen)
+	std::cout << "#" << std::endl;
+	cp.print_warnings();
+
+	p.R = (float)p.codec->enc->K / (float)p.codec->enc->N_cw; // compute the code rate
+}
+
+void init_modules_and_utils(const params &p, modules &m, utils &u)
+{
+	// get the thread id from OpenMP
+	const int tid = omp_get_thread_num();
+
+	// set different seeds for different threads when the module use a PRNG (the parameters are shared by the threads)
+	std::unique_ptr<factory::Source ::parameters> p_source (p.source ->clone());
+	std::unique_ptr<factory::Channel::parameters> p_channel(p.channel->clone());
+	p_source ->seed += tid;
+	p_channel->seed += tid;
+
+	m.source        = std::unique_ptr<module::Source      <>>(p_source ->build());
+	m.codec         = std::unique_ptr<module::Codec_SIHO  <>>(p.codec  ->build());
+	m.modem         = std::unique_ptr<module::Modem       <>>(p.modem  ->build());
+	m.channel       = std::unique_ptr<module::Channel     <>>(p_channel->build());
+	u.monitors[tid] = std::unique_ptr<module::Monitor_BFER<>>(p.monitor->build());
+	m.monitor       = u.monitors[tid].get();
+	m.encoder       = m.codec->get_encoder().get();
+	m.decoder       = m.codec->get_decoder_siho().get();
+
+	m.list = { m.source.get(), m.modem.get(), m.channel.get(), m.monitor, m.encoder, m.decoder };
+
+	// configuration of the module tasks
+	for (auto& mod : m.list)
+		for (auto& tsk : mod->tasks)
+		{
+			tsk->set_autoalloc  (true ); // enable the automatic allocation of the data in the tasks
+			tsk->set_autoexec   (false); // disable the auto execution mode of the tasks
+			tsk->set_debug      (false); // disable the debug mode
+			tsk->set_debug_limit(16   ); // display only the 16 first bits if the debug mode is enabled
+			tsk->set_stats      (false); // disable the statistics, they would be part of the measured time
+
+			// enable the fast mode (= disable the useless verifs in the tasks) if there is no debug and stats modes
+			if (!tsk->is_debug() && !tsk->is_stats())
+				tsk->set_fast(true);
+		}
+
+	// reset the memory of the decoder after the end of each communication
+	m.monitor->add_handler_check(std::bind(&module::Decoder::reset, m.decoder));
+
+	// initialize the interleaver if this code use an interleaver
+	try
+	{
+		auto& interleaver = m.codec->get_interleaver();
+		interleaver->init();
+	}
+	catch (const std::exception&) { /* do nothing if there is no interleaver */ }
+}
+
+void init_utils(const params &p, utils &u)
+{
+	// allocate a common monitor module to reduce all the monitors
+	u.monitor_red = std::unique_ptr<module::Monitor_BFER_reduction>(new module::Monitor_BFER_reduction(u.monitors));
+	u.monitor_red->set_reduce_frequency(std::chrono::milliseconds(500));
+	// create a sigma noise type
+	u.noise = std::unique_ptr<tools::Sigma<>>(new tools::Sigma<>());
+	// report the noise values (Es/N0 and Eb/N0)
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_noise<>(*u.noise)));
+	// report the bit/frame error rates
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_BFER<>(*u.monitor_red)));
+	// report the simulation throughputs
+	u.reporters.push_back(std::unique_ptr<tools::Reporter>(new tools::Reporter_throughput<>(*u.monitor_red)));
+	// measure the time spent by the terminal thread in each reporter
+	for (auto &r : u.reporters)
+		u.reporters_timed.push_back(std::unique_ptr<tools::Reporter>(new Reporter_timed(*r)));
+	// create a terminal that will display the collected data from the reporters
+	u.terminal = std::unique_ptr<tools::Terminal>(p.terminal->build(u.reporters_timed));
+}
+
+void display_results(const std::vector<result> &results)
+{
+	if (results.empty())
+		return;
+
+	auto percent = [](const std::chrono::nanoseconds &d, const double t_total) -> double
+	{
+		return t_total > 0. ? 100. * std::chrono::duration<double>(d).count() / t_total : 0.;
+	};
+
+	std::cout << "#" << std::endl;
+	std::cout << "# Scaling of the simulation chain (the synchronization times are given in % of the total thread time):" << std::endl;
+	std::cout << "# ------------------------------------------------------------------------------------------------------------------------" << std::endl;
+	std::cout << "#  Threads | Thr. (Mb/s) | Speedup | Efficiency | Serial fr. | is_done_all | barrier | single | reporter | SNR end (ms) | Dominant" << std::endl;
+	std::cout << "# ------------------------------------------------------------------------------------------------------------------------" << std::endl;
+
+	const auto thr_ref = results[0].throughput / (double)results[0].n_threads;
+	for (auto &r : results)
+	{
+		const auto n          = (double)r.n_threads;
+		const auto speedup    = r.throughput / thr_ref;
+		const auto efficiency = speedup / n;
+		// Karp-Flatt metric: experimentally determined serial fraction (Amdahl's law)
+		const auto serial     = r.n_threads > 1 ? (1. / speedup - 1. / n) / (1. - 1. / n) : 0.;
+
+		// total time of the simulation threads
+		const auto t_total = r.t_wall * n;
+		const std::vector<std::pair<std::string, double>> syncs = { { "is_done_all", percent(r.t.is_done_all, t_total) },
+		                                                            { "barrier",     percent(r.t.barrier,     t_total) },
+		                                                            { "single",      percent(r.t.single,      t_total) },
+		                                                            { "reporter",    percent(r.reporter,      t_total) } };
+		// average time of a thread in the barrier and the single section which end each SNR point
+		const auto t_snr_end = r.n_snrs ? 1e3 * std::chrono::duration<double>(r.t.barrier + r.t.single).count() /
+		                                  (n * (double)r.n_snrs) : 0.;
+		const auto dominant = std::max_element(syncs.begin(), syncs.end(),
+		                                       [](const std::pair<std::string, double> &a,
+		                                          const std::pair<std::string, double> &b) { return a.second < b.second; });
+
+		std::cout << "# " << std::fixed
+		          << std::setw(8)  << r.n_threads                                   << " | "
+		          << std::setw(11) << std::setprecision(2) << r.throughput          << " | "
+		          << std::setw(7)  << std::setprecision(2) << speedup               << " | "
+		          << std::setw(9)  << std::setprecision(1) << efficiency * 100. << "%" << " | "
+		          << std::setw(10) << std::setprecision(4) << serial                << " | "
+		          << std::setw(10) << std::setprecision(2) << syncs[0].second << "%" << " | "
+		          << std::setw(6)  << std::setprecision(2) << syncs[1].second << "%" << " | "
+		          << std::setw(5)  << std::setprecision(2) << syncs[2].second << "%" << " | "
+		          << std::setw(7)  << std::setprecision(2) << syncs[3].second << "%" << " | "
+		          << std::setw(12) << std::setprecision(3) << t_snr_end             << " | "
+		          << dominant->first << std::endl;
+	}
+	std::cout << "#" << std::endl;
+}
@@ -61,15 +61,36 @@ int sc_main(int argc, char** argv)
 	// display the legend in the terminal
 	u.terminal->legend();
 
-	// add a callback to the monitor to call the "sc_core::sc_stop()" function
-	m.monitor->add_handler_check([&m, &u]() -> void
-	{
-		if (m.monitor->fe_limit_achieved() || u.terminal->is_interrupt())
-			sc_core::sc_stop();
-	});
-
-	// a loop over the various SNRs
+	// create "sc_core::sc_module" instances for each task, they are kept for all the SNRs
+	using namespace module;
+	m.source ->sc.create_module(+src::tsk::generate    );
+	m.encoder->sc.create_module(+enc::tsk::encode      );
+	m.modem  ->sc.create_module(+mdm::tsk::modulate    );
+	m.modem  ->sc.create_module(+mdm::tsk::demodulate  );
+	m.channel->sc.create_module(+chn::tsk::add_noise   );
+	m.decoder->sc.create_module(+dec::tsk::decode_siho );
+	m.monitor->sc.create_module(+mnt::tsk::check_errors);
+
+	// declare a SystemC duplicator to duplicate the source 'generate' task output
+	tools::SC_Duplicator duplicator;
+
+	// bind the sockets between the modules
+	m.source ->sc[+src::tsk::generate   ].s_out[+src::sck::generate   ::U_K ](duplicator                            .s_in                               );
+	duplicator                           .s_out1                             (m.monitor->sc[+mnt::tsk::check_errors].s_in[+mnt::sck::check_errors::U   ]);
+	duplicator                           .s_out2                             (m.encoder->sc[+enc::tsk::encode      ].s_in[+enc::sck::encode      ::U_K ]);
+	m.encoder->sc[+enc::tsk::encode     ].s_out[+enc::sck::encode     ::X_N ](m.modem  ->sc[+mdm::tsk::modulate    ].s_in[+mdm::sck::modulate    ::X_N1]);
+	m.modem  ->sc[+mdm::tsk::modulate   ].s_out[+mdm::sck::modulate   ::X_N2](m.channel->sc[+chn::tsk::add_noise   ].s_in[+chn::sck::add_noise   ::X_N ]);
+	m.channel->sc[+chn::tsk::add_noise  ].s_out[+chn::sck::add_noise  ::Y_N ](m.modem  ->sc[+mdm::tsk::demodulate  ].s_in[+mdm::sck::demodulate  ::Y_N1]);
+	m.modem  ->sc[+mdm::tsk::demodulate ].s_out[+mdm::sck::demodulate ::Y_N2](m.decoder->sc[+dec::tsk::decode_siho ].s_in[+dec::sck::decode_siho ::Y_N ]);
+	m.decoder->sc[+dec::tsk::decode_siho].s_out[+dec::sck::decode_siho::V_K ](m.monitor->sc[+mnt::tsk::check_errors].s_in[+mnt::sck::check_errors::V   ]);
+
+	// list of the SNRs to simulate
+	std::vector<float> ebn0s;
 	for (auto ebn0 = p.ebn0_min; ebn0 < p.ebn0_max; ebn0 += p.ebn0_step)
+		ebn0s.push_back(ebn0);
+	size_t cur = 0;
+
+	auto set_noise = [&p, &m, &u](const float ebn0)
 	{
 		// compute the current sigma for the channel noise
 		const auto esn0  = tools::ebn0_to_esn0 (ebn0, p.R);
@@ -80,36 +101,14 @@ int sc_main(int argc, char** argv)
 		// update the sigma of the modem and the channel
 		m.modem  ->set_noise(*u.noise);
 		m.channel->set_noise(*u.noise);
+	};
 
-		// create "sc_core::sc_module" instances for each task
-		using namespace module;
-		m.source ->sc.create_module(+src::tsk::generate    );
-		m.encoder->sc.create_module(+enc::tsk::encode      );
-		m.modem  ->sc.create_module(+mdm::tsk::modulate    );
-		m.modem  ->sc.create_module(+mdm::tsk::demodulate  );
-		m.channel->sc.create_module(+chn::tsk::add_noise   );
-		m.decoder->sc.create_module(+dec::tsk::decode_siho );
-		m.monitor->sc.create_module(+mnt::tsk::check_errors);
-
-		// declare a SystemC duplicator to duplicate the source 'generate' task output
-		tools::SC_Duplicator duplicator;
-
-		// bind the sockets between the modules
-		m.source ->sc[+src::tsk::generate   ].s_out[+src::sck::generate   ::U_K ](duplicator                            .s_in                               );
-		duplicator                           .s_out1                             (m.monitor->sc[+mnt::tsk::check_errors].s_in[+mnt::sck::check_errors::U   ]);
-		duplicator                           .s_out2                             (m.encoder->sc[+enc::tsk::encode      ].s_in[+enc::sck::encode      ::U_K ]);
-		m.encoder->sc[+enc::tsk::encode     ].s_out[+enc::sck::encode     ::X_N ](m.modem  ->sc[+mdm::tsk::modulate    ].s_in[+mdm::sck::modulate    ::X_N1]);
-		m.modem  ->sc[+mdm::tsk::modulate   ].s_out[+mdm::sck::modulate   ::X_N2](m.channel->sc[+chn::tsk::add_noise   ].s_in[+chn::sck::add_noise   ::X_N ]);
-		m.channel->sc[+chn::tsk::add_noise  ].s_out[+chn::sck::add_noise  ::Y_N ](m.modem  ->sc[+mdm::tsk::demodulate  ].s_in[+mdm::sck::demodulate  ::Y_N1]);
-		m.modem  ->sc[+mdm::tsk::demodulate ].s_out[+mdm::sck::demodulate ::Y_N2](m.decoder->sc[+dec::tsk::decode_siho ].s_in[+dec::sck::decode_siho ::Y_N ]);
-		m.decoder->sc[+dec::tsk::decode_siho].s_out[+dec::sck::decode_siho::V_K ](m.monitor->sc[+mnt::tsk::check_errors].s_in[+mnt::sck::check_errors::V   ]);
-
-		// display the performance (BER and FER) in real time (in a separate thread)
-		u.terminal->start_temp_report();
-
-		// start the SystemC simulation
-		sc_core::sc_report_handler::set_actions(sc_core::SC_INFO, sc_core::SC_DO_NOTHING);
-		sc_core::sc_start();
+	// add a callback to the monitor to switch to the next SNR, the SystemC simulation is only stopped after the last
+	// SNR: a frame goes through the whole chain before the next one is generated, so no frame is shared by two SNRs
+	m.monitor->add_handler_check([&]() -> void
+	{
+		if (!m.monitor->fe_limit_achieved() && !u.terminal->is_interrupt())
+			return;
 
 		// display the performance (BER and FER) in the terminal
 		u.terminal->final_report();
@@ -118,12 +117,29 @@ int sc_main(int argc, char** argv)
 		m.monitor->reset();
 		u.terminal->reset();
 
-		// if user pressed Ctrl+c twice, exit the SNRs loop
-		if (u.terminal->is_over()) break;
+		// if user pressed Ctrl+c twice or if all the SNRs have been simulated, stop the SystemC simulation
+		if (u.terminal->is_over() || ++cur >= ebn0s.size())
+		{
+			sc_core::sc_stop();
+			return;
+		}
+
+		set_noise(ebn0s[cur]);
 
-		// dirty way to create a new SystemC simulation context
-		sc_core::sc_curr_simcontext = new sc_core::sc_simcontext();
-		sc_core::sc_default_global_context = sc_core::sc_curr_simcontext;
+		// display the performance (BER and FER) of the next SNR in real time (in a separate thread)
+		u.terminal->start_temp_report();
+	});
+
+	if (!ebn0s.empty())
+	{
+		set_noise(ebn0s[cur]);
+
+		// display the performance (BER and FER) in real time (in a separate thread)
+		u.terminal->start_temp_report();
+
+		// start the SystemC simulation, once for all the SNRs
+		sc_core::sc_report_handler::set_actions(sc_core::SC_INFO, sc_core::SC_DO_NOTHING);
+		sc_core::sc_start();
 	}
 
 	// display the statistics of the tasks (if enabled)